@@ -0,0 +1,470 @@
+// OrderBook microbenchmarks. Each sample times a batch of operations and
+// records the mean ns/op of that batch; percentiles are taken over samples.
+// Book setup and repair between samples is not timed.
+//
+//   orderbook_bench [--filter SUBSTR] [--samples N] [--json FILE]
+//                   [--baseline FILE] [--threshold PCT]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "core/OrderBook.hpp"
+#include "utils/Log.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+struct Result {
+    std::string name;
+    std::size_t samples = 0;
+    std::size_t opsPerSample = 0;
+    double nsPerOp = 0.0;
+    double opsPerSec = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+struct Options {
+    std::string filter;
+    std::size_t samples = 200;
+    std::string jsonPath;
+    std::string baselinePath;
+    double thresholdPct = 5.0;
+};
+
+double percentile(std::vector<double> sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    std::size_t index = static_cast<std::size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    index = std::min(sorted.size() - 1, index > 0 ? index - 1 : 0);
+    return sorted[index];
+}
+
+// prepare() runs untimed before each sample; op(i) runs `batch` times timed
+Result measure(const std::string& name, std::size_t samples, std::size_t batch,
+               const std::function<void()>& prepare, const std::function<void(std::size_t)>& op) {
+    std::vector<double> perOp;
+    perOp.reserve(samples);
+    double totalNs = 0.0;
+
+    // One warm-up sample
+    prepare();
+    for (std::size_t i = 0; i < batch; ++i) op(i);
+
+    for (std::size_t s = 0; s < samples; ++s) {
+        prepare();
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < batch; ++i) op(i);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        totalNs += ns;
+        perOp.push_back(ns / static_cast<double>(batch));
+    }
+
+    std::sort(perOp.begin(), perOp.end());
+    Result result;
+    result.name = name;
+    result.samples = samples;
+    result.opsPerSample = batch;
+    result.nsPerOp = totalNs / static_cast<double>(samples * batch);
+    result.opsPerSec = result.nsPerOp > 0 ? 1e9 / result.nsPerOp : 0.0;
+    result.p50 = percentile(perOp, 0.50);
+    result.p90 = percentile(perOp, 0.90);
+    result.p99 = percentile(perOp, 0.99);
+    result.max = perOp.back();
+    return result;
+}
+
+Order makeOrder(int agentId, double price, int qty, OrderSide side) {
+    return Order{-1, agentId, OrderBook::limitTick(side, price), qty, side, OrderType::Limit, 0};
+}
+
+// Rests `count` orders on each side, spread over `levels` price levels per
+// side between 99.00-99.99 (bids) and 100.01-101.00 (asks)
+void populate(OrderBook& book, std::size_t count, std::size_t levels, std::mt19937& rng) {
+    std::uniform_int_distribution<int> level(0, static_cast<int>(levels) - 1);
+    for (std::size_t i = 0; i < count; ++i) {
+        int agent = 1000 + static_cast<int>(i % 500);
+        book.addLimitOrder(makeOrder(agent, 99.99 - level(rng) * 0.01, 10, OrderSide::BUY));
+        book.addLimitOrder(makeOrder(agent, 100.01 + level(rng) * 0.01, 10, OrderSide::SELL));
+    }
+    book.clearFills();
+}
+
+void benchAddResting(std::vector<Result>& out, std::size_t samples) {
+    constexpr std::size_t batch = 1000;
+    OrderBook book;
+    std::mt19937 rng(1);
+    populate(book, 500, 100, rng);
+
+    std::vector<Order> orders(batch);
+    std::uniform_int_distribution<int> level(0, 99);
+    std::vector<OrderHandle> handles(batch);
+
+    out.push_back(measure("add_limit/resting", samples, batch,
+        [&] {
+            for (auto handle : handles) book.cancelOrder(handle);
+            book.clearFills();
+            for (std::size_t i = 0; i < batch; ++i) {
+                bool buy = (i & 1) == 0;
+                orders[i] = makeOrder(1, buy ? 99.99 - level(rng) * 0.01 : 100.01 + level(rng) * 0.01, 5,
+                                      buy ? OrderSide::BUY : OrderSide::SELL);
+            }
+        },
+        [&](std::size_t i) { handles[i] = book.addLimitOrder(orders[i]); }));
+}
+
+void benchAddCrossing(std::vector<Result>& out, std::size_t samples) {
+    constexpr std::size_t batch = 1000;
+    OrderBook book;
+    // Deep enough that a sample never empties the touch
+    book.addLimitOrder(makeOrder(2, 100.01, 1 << 30, OrderSide::SELL));
+    book.addLimitOrder(makeOrder(2, 99.99, 1 << 30, OrderSide::BUY));
+    std::vector<Fill> executions;
+    executions.reserve(batch);
+
+    out.push_back(measure("add_limit/crossing", samples, batch,
+        [&] {
+            book.clearFills();
+            executions.clear();
+        },
+        [&](std::size_t i) {
+            bool buy = (i & 1) == 0;
+            book.addLimitOrder(makeOrder(1, buy ? 100.05 : 99.95, 1, buy ? OrderSide::BUY : OrderSide::SELL),
+                               &executions);
+        }));
+}
+
+// Cancels orders at one position of a single deep level
+void benchCancel(std::vector<Result>& out, std::size_t samples, const std::string& where) {
+    constexpr std::size_t depth = 10000;
+    constexpr std::size_t batch = 100;
+    OrderBook book;
+    std::mt19937 rng(2);
+    populate(book, 1000, 50, rng);
+
+    // FIFO of handles at the 98.00 bid level
+    std::vector<OrderHandle> queue;
+    for (std::size_t i = 0; i < depth + batch; ++i) {
+        queue.push_back(book.addLimitOrder(makeOrder(3, 98.00, 1, OrderSide::BUY)));
+    }
+    std::vector<OrderHandle> targets(batch);
+
+    out.push_back(measure("cancel/" + where, samples, batch,
+        [&] {
+            // Refill to depth + batch, then pick this sample's victims
+            while (queue.size() < depth + batch) {
+                queue.push_back(book.addLimitOrder(makeOrder(3, 98.00, 1, OrderSide::BUY)));
+            }
+            book.clearFills();
+            std::size_t first = where == "front" ? 0
+                              : where == "back" ? queue.size() - batch
+                              : (queue.size() - batch) / 2;
+            std::copy(queue.begin() + first, queue.begin() + first + batch, targets.begin());
+            queue.erase(queue.begin() + first, queue.begin() + first + batch);
+        },
+        [&](std::size_t i) { doNotOptimize(book.cancelOrder(targets[i])); }));
+}
+
+// Market order that consumes exactly `levels` ask levels
+void benchSweep(std::vector<Result>& out, std::size_t samples, int levels) {
+    constexpr int ordersPerLevel = 10;
+    constexpr int qtyPerOrder = 10;
+    OrderBook book;
+    std::mt19937 rng(3);
+    populate(book, 200, 50, rng);  // bids only matter for the mid; asks get swept too
+
+    // Clear asks so the sweep sees only the levels built below
+    book.matchMarketOrder(makeOrder(9, 0.0, 1 << 30, OrderSide::BUY));
+    book.clearFills();
+
+    Order sweep = makeOrder(1, 0.0, levels * ordersPerLevel * qtyPerOrder, OrderSide::BUY);
+    auto refill = [&] {
+        book.clearFills();
+        for (int l = 0; l < levels; ++l) {
+            for (int o = 0; o < ordersPerLevel; ++o) {
+                book.addLimitOrder(makeOrder(4 + o, 100.01 + l * 0.01, qtyPerOrder, OrderSide::SELL));
+            }
+        }
+        book.clearFills();
+    };
+    out.push_back(measure("match/sweep_" + std::to_string(levels), samples, 1, refill,
+        [&](std::size_t) { doNotOptimize(book.matchMarketOrder(sweep)); }));
+
+    // Same sweep reporting into a reused vector through a FillSink
+    std::vector<Fill> executions;
+    executions.reserve(static_cast<std::size_t>(levels * ordersPerLevel));
+    out.push_back(measure("match/sweep_" + std::to_string(levels) + "_sink", samples, 1,
+        [&] {
+            refill();
+            executions.clear();
+        },
+        [&](std::size_t) { doNotOptimize(book.matchMarketOrder(sweep, executions)); }));
+}
+
+// Market order from an agent whose own quotes fill the first `ownLevels`
+// ask levels (50 orders each); under the default Skip policy it steps over
+// them and sweeps 10 levels of other agents' orders behind
+void benchSelfTrade(std::vector<Result>& out, std::size_t samples, int ownLevels) {
+    constexpr int ownPerLevel = 50;
+    constexpr int otherLevels = 10;
+    constexpr int ordersPerLevel = 10;
+    OrderBook book;
+    for (int l = 0; l < ownLevels; ++l) {
+        for (int o = 0; o < ownPerLevel; ++o) {
+            book.addLimitOrder(makeOrder(1, 100.01 + l * 0.01, 10, OrderSide::SELL));
+        }
+    }
+
+    Order sweep = makeOrder(1, 0.0, otherLevels * ordersPerLevel * 10, OrderSide::BUY);
+    out.push_back(measure("match/self_skip_" + std::to_string(ownLevels), samples, 1,
+        [&] {
+            book.clearFills();
+            for (int l = 0; l < otherLevels; ++l) {
+                for (int o = 0; o < ordersPerLevel; ++o) {
+                    book.addLimitOrder(makeOrder(4 + o, 100.01 + (ownLevels + l) * 0.01, 10, OrderSide::SELL));
+                }
+            }
+            book.clearFills();
+        },
+        [&](std::size_t) { doNotOptimize(book.matchMarketOrder(sweep, FillSink())); }));
+}
+
+// Market order whose trade fires one stop among `parked` that stay put
+void benchStopTrigger(std::vector<Result>& out, std::size_t samples, int parked) {
+    OrderBook book;
+    for (int i = 0; i < parked; ++i) {
+        bool buy = (i % 2 == 0);
+        Order stop = makeOrder(6, 0.0, 1, buy ? OrderSide::BUY : OrderSide::SELL);
+        stop.type = OrderType::Stop;
+        double trigger = buy ? 150.0 + (i % 1000) * 0.01 : 50.0 - (i % 1000) * 0.01;
+        book.submitOrder(stop, OrderParams{OrderBook::toTicks(trigger)});
+    }
+
+    Order lift = makeOrder(1, 0.0, 1, OrderSide::BUY);
+    out.push_back(measure("stops/trigger_" + std::to_string(parked), samples, 1,
+        [&] {
+            book.clearFills();
+            book.addLimitOrder(makeOrder(2, 100.02, 1, OrderSide::SELL));
+            book.addLimitOrder(makeOrder(3, 101.00, 1, OrderSide::SELL));
+            Order stop = makeOrder(5, 0.0, 1, OrderSide::BUY);
+            stop.type = OrderType::Stop;
+            book.submitOrder(stop, OrderParams{OrderBook::toTicks(100.02)});
+            book.clearFills();
+        },
+        [&](std::size_t) { doNotOptimize(book.matchMarketOrder(lift, FillSink())); }));
+}
+
+// A batch of 1-lot crossing limit and market orders through submitBatch
+void benchBatch(std::vector<Result>& out, std::size_t samples) {
+    constexpr std::size_t batch = 1000;
+    OrderBook book;
+    book.addLimitOrder(makeOrder(2, 100.01, 1 << 30, OrderSide::SELL));
+    book.addLimitOrder(makeOrder(2, 99.99, 1 << 30, OrderSide::BUY));
+
+    std::vector<Order> orders(batch);
+    for (std::size_t i = 0; i < batch; ++i) {
+        bool buy = (i & 1) == 0;
+        orders[i] = makeOrder(1, buy ? 100.05 : 99.95, 1, buy ? OrderSide::BUY : OrderSide::SELL);
+        if ((i & 2) == 0) orders[i].type = OrderType::Market;
+    }
+    std::vector<Fill> fills;
+    fills.reserve(2 * batch);
+
+    // One timed op is the whole batch; report it per order
+    Result result = measure("batch/submit_1k", samples, 1,
+        [&] {
+            fills.clear();
+        },
+        [&](std::size_t) { book.submitBatch(orders, fills); });
+    for (double* ns : {&result.nsPerOp, &result.p50, &result.p90, &result.p99, &result.max}) *ns /= batch;
+    result.opsPerSample = batch;
+    result.opsPerSec = result.nsPerOp > 0 ? 1e9 / result.nsPerOp : 0.0;
+    out.push_back(result);
+}
+
+void benchTopOfBook(std::vector<Result>& out, std::size_t samples, std::size_t resting) {
+    constexpr std::size_t batch = 1000;
+    OrderBook book;
+    std::mt19937 rng(4);
+    populate(book, resting / 2, std::max<std::size_t>(1, std::min<std::size_t>(resting / 20, 100)), rng);
+    std::string suffix = "/" + std::to_string(resting);
+
+    auto nothing = [] {};
+    out.push_back(measure("top/best_bid" + suffix, samples, batch, nothing,
+                          [&](std::size_t) { doNotOptimize(book.bestBid()); }));
+    out.push_back(measure("top/best_ask" + suffix, samples, batch, nothing,
+                          [&](std::size_t) { doNotOptimize(book.bestAsk()); }));
+    out.push_back(measure("top/mid" + suffix, samples, batch, nothing,
+                          [&](std::size_t) { doNotOptimize(book.getMidPrice()); }));
+
+    BookDepth<10> depth;
+    out.push_back(measure("top/depth_10" + suffix, samples, batch, nothing,
+                          [&](std::size_t) { book.depthSnapshot(depth); doNotOptimize(depth.bidLevels); }));
+}
+
+void writeJson(const std::vector<Result>& results, const std::string& path) {
+    std::ofstream out(path);
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\""
+            << ", \"samples\": " << r.samples
+            << ", \"ops_per_sample\": " << r.opsPerSample
+            << ", \"ns_per_op\": " << r.nsPerOp
+            << ", \"ops_per_sec\": " << r.opsPerSec
+            << ", \"p50_ns\": " << r.p50
+            << ", \"p90_ns\": " << r.p90
+            << ", \"p99_ns\": " << r.p99
+            << ", \"max_ns\": " << r.max << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Reads name -> ns_per_op from a file produced by writeJson. Throws
+// std::runtime_error if the file cannot be read or holds no benchmarks.
+std::map<std::string, double> readBaseline(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot open file");
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+
+    std::map<std::string, double> baseline;
+    const std::string nameKey = "\"name\": \"";
+    const std::string nsKey = "\"ns_per_op\": ";
+    for (std::size_t pos = text.find(nameKey); pos != std::string::npos; pos = text.find(nameKey, pos)) {
+        pos += nameKey.size();
+        std::size_t end = text.find('"', pos);
+        std::size_t nsPos = text.find(nsKey, end);
+        if (end == std::string::npos || nsPos == std::string::npos) {
+            throw std::runtime_error("benchmark without ns_per_op");
+        }
+        std::string name = text.substr(pos, end - pos);
+        try {
+            baseline[name] = std::stod(text.substr(nsPos + nsKey.size()));
+        } catch (const std::logic_error&) {
+            throw std::runtime_error("bad ns_per_op for " + name);
+        }
+        pos = nsPos;
+    }
+    if (baseline.empty()) throw std::runtime_error("no benchmarks found");
+    return baseline;
+}
+
+void printTable(const std::vector<Result>& results, const std::map<std::string, double>& baseline,
+                double thresholdPct) {
+    std::cout << std::left << std::setw(26) << "benchmark" << std::right
+              << std::setw(12) << "ns/op" << std::setw(14) << "ops/sec"
+              << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+              << std::setw(10) << "max";
+    if (!baseline.empty()) std::cout << std::setw(12) << "vs base";
+    std::cout << "\n";
+
+    for (const Result& r : results) {
+        std::cout << std::left << std::setw(26) << r.name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(12) << r.nsPerOp
+                  << std::setprecision(0) << std::setw(14) << r.opsPerSec
+                  << std::setprecision(1) << std::setw(10) << r.p50 << std::setw(10) << r.p90
+                  << std::setw(10) << r.p99 << std::setw(10) << r.max;
+        if (!baseline.empty()) {
+            auto it = baseline.find(r.name);
+            if (it != baseline.end() && it->second > 0) {
+                double delta = (r.nsPerOp - it->second) / it->second * 100.0;
+                std::cout << std::setw(10) << std::showpos << delta << "%" << std::noshowpos;
+                if (delta > thresholdPct) std::cout << "  REGRESSION";
+                else if (delta < -thresholdPct) std::cout << "  faster";
+            } else {
+                std::cout << std::setw(12) << "new";
+            }
+        }
+        std::cout << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) options.filter = argv[++i];
+        else if (arg == "--samples" && i + 1 < argc) options.samples = std::stoul(argv[++i]);
+        else if (arg == "--json" && i + 1 < argc) options.jsonPath = argv[++i];
+        else if (arg == "--baseline" && i + 1 < argc) options.baselinePath = argv[++i];
+        else if (arg == "--threshold" && i + 1 < argc) options.thresholdPct = std::stod(argv[++i]);
+        else {
+            std::cout << "Usage: " << argv[0] << " [--filter SUBSTR] [--samples N] [--json FILE]"
+                      << " [--baseline FILE] [--threshold PCT]\n";
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    // Read the baseline first, so that a bad path fails before the run
+    std::map<std::string, double> baseline;
+    if (!options.baselinePath.empty()) {
+        try {
+            baseline = readBaseline(options.baselinePath);
+        } catch (const std::exception& e) {
+            std::cerr << "Cannot read baseline " << options.baselinePath << ": " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    // submitIntent traces fills at debug level
+    logging::setLevel(LogLevel::Error);
+
+    using Bench = std::function<void(std::vector<Result>&, std::size_t)>;
+    const std::vector<std::pair<std::string, Bench>> suite = {
+        {"add_limit/resting", benchAddResting},
+        {"add_limit/crossing", benchAddCrossing},
+        {"cancel/front", [](auto& out, auto n) { benchCancel(out, n, "front"); }},
+        {"cancel/middle", [](auto& out, auto n) { benchCancel(out, n, "middle"); }},
+        {"cancel/back", [](auto& out, auto n) { benchCancel(out, n, "back"); }},
+        {"match/sweep_1", [](auto& out, auto n) { benchSweep(out, n, 1); }},
+        {"match/sweep_10", [](auto& out, auto n) { benchSweep(out, n, 10); }},
+        {"match/sweep_100", [](auto& out, auto n) { benchSweep(out, n, 100); }},
+        {"match/self_skip_10", [](auto& out, auto n) { benchSelfTrade(out, n, 10); }},
+        {"stops/trigger_10000", [](auto& out, auto n) { benchStopTrigger(out, n, 10000); }},
+        {"batch/intents_1k", benchBatch},
+        {"top/10", [](auto& out, auto n) { benchTopOfBook(out, n, 10); }},
+        {"top/1000", [](auto& out, auto n) { benchTopOfBook(out, n, 1000); }},
+        {"top/100000", [](auto& out, auto n) { benchTopOfBook(out, n, 100000); }},
+    };
+
+    std::vector<Result> results;
+    for (const auto& [name, bench] : suite) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) continue;
+        bench(results, options.samples);
+    }
+
+    printTable(results, baseline, options.thresholdPct);
+
+    if (!options.jsonPath.empty()) writeJson(results, options.jsonPath);
+    return 0;
+}
@@ -1,7 +1,23 @@
 #pragma once
 
+#include <cstddef>
 #include <deque>
+#include <span>
+#include <vector>
+#include "core/Money.hpp"
 #include "core/Order.hpp"
+#include "core/OrderIntent.hpp"
+
+// How closing trades are matched against the open position for realized PnL.
+// Unrealized PnL is the same either way (mark * inventory - cost basis).
+enum class CostBasisMethod {
+    FIFO,         // oldest lots close first
+    AverageCost   // closes at the weighted average entry price
+};
+
+class BinaryWriter;
+class BinaryReader;
+class RiskLedger;
 
 class Agent {
 public:
@@ -9,30 +25,72 @@ public:
     double startCash = 10000.0;
     virtual ~Agent() = default;
 
-    virtual void act(class OrderBook& book, long timestamp) = 0;
+    // Decision logic: read the snapshot and append orders to `out`. Must only
+    // touch this agent's own state, since agents may decide in parallel.
+    virtual void decide(const MarketSnapshot& market, long timestamp, std::vector<OrderIntent>& out);
+    // Sequential path: decide against the live book and submit immediately.
+    // Agents that need more than a snapshot can override this instead, but
+    // then only run in the simulator's sequential mode.
+    virtual void act(OrderBook& book, long timestamp);
+    // Event-driven runs: when this agent next wants to decide, given that
+    // it just decided at `now`. Negative means never. Default: every tick.
+    virtual long nextWakeup(long now) { return now + 1; }
+    // An execution of one of this agent's orders; fill.side is the side of
+    // that order
     virtual void onFill(const Fill& fill);
+    // Batched delivery of one step's fills for this agent, in book order.
+    // Defaults to the per-fill overload; subclasses overriding either
+    // should add `using Agent::onFill;` to keep the other visible.
+    virtual void onFill(std::span<const Fill> fills);
 
-    // Accessor methods
+    // Checkpointing: account and open lots. Subclasses with
+    // state of their own extend both and call the base version first.
+    virtual void saveState(BinaryWriter& out) const;
+    virtual void loadState(BinaryReader& in);
+
+    // Strategy name, used to group results across agents and runs
+    virtual const char* getType() const { return "Agent"; }
+
+    // Accessor methods. Money is kept in fixed point (see Money.hpp) and
+    // converted here.
     int getId() const;
     double getCash() const;
     int getInventory() const;
     double getRealizedPnL() const;
+    // O(1): kept as running aggregates rather than summed over lots
     double getUnrealizedPnL(double marketPrice) const;
+    // Signed sum of entry price * quantity over the open position
+    double getCostBasis() const { return moneyToDouble(costBasis); }
+    std::size_t getLotCount() const { return positionQueue.size(); }
+
+    CostBasisMethod getCostBasisMethod() const { return costBasisMethod; }
+    // Only while flat; throws std::logic_error with a position open
+    void setCostBasisMethod(CostBasisMethod method);
     
-    // Resource management methods
+    // Cash and inventory not committed to resting orders, as recorded in the
+    // ledger of the book the agent trades on (everything, without one)
     int getAvailableInventory() const;
     double getAvailableCash() const;
-    void cancelReservation(OrderSide side, int quantity, double price);
+    // Set by the simulator when the agent joins; not owned
+    void setLedger(const RiskLedger* ledger) { this->ledger = ledger; }
 
 protected:
     int id;
-    double cash;
+    Money cash;
     int inventory;
-    double realizedPnL;
-    
-    int reservedLongInventory;
-    int reservedShortInventory;
-    double reservedCash;
-    
-    std::deque<std::pair<int, double>> positionQueue;
+    Money realizedPnL;
+    const RiskLedger* ledger = nullptr;
+
+    // Open lots (FIFO mode only), all of one sign; a lot at the same price
+    // as the newest one is merged into it
+    std::deque<std::pair<int, Money>> positionQueue;
+    Money costBasis;
+    CostBasisMethod costBasisMethod;
+
+    // Moves the position by `signedQty` at `price`, realizing PnL on the part
+    // that closes existing exposure
+    void applyTrade(int signedQty, Money price);
+
+private:
+    std::vector<OrderIntent> actIntents;  // scratch for act()
 };
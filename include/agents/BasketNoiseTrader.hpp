@@ -0,0 +1,19 @@
+#pragma once
+
+#include "agents/MultiAssetAgent.hpp"
+#include "utils/CounterRng.hpp"
+#include <cstdint>
+
+// NoiseTrader across a basket: each step it picks one instrument at random
+// and places a random limit or market order there, sized against the
+// shared cash pool.
+class BasketNoiseTrader : public MultiAssetAgent {
+public:
+    BasketNoiseTrader(int id, std::size_t instruments, std::uint64_t seed);
+
+    void decide(std::span<const MarketSnapshot> markets, long timestamp,
+                std::vector<InstrumentIntent>& out) override;
+
+private:
+    AgentRng rng;  // keyed by (seed, id); drawn per timestamp
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "core/Money.hpp"
+#include "core/Order.hpp"
+#include "core/OrderIntent.hpp"
+#include "core/RiskLedger.hpp"
+
+// An intent routed to one instrument's book
+struct InstrumentIntent {
+    std::uint32_t instrument;
+    OrderIntent intent;
+};
+
+// Per-instrument slice of an agent's account. Cash lives in the shared pool
+// on MultiAssetAgent.
+struct InstrumentPosition {
+    int inventory = 0;
+    Money costBasis = 0;  // signed cost of the open position (average cost)
+    Money realizedPnL = 0;
+
+    double getUnrealizedPnL(double marketPrice) const { return inventory * marketPrice - moneyToDouble(costBasis); }
+};
+
+// Base for agents trading several instruments out of one cash pool. Fills
+// carry the side of the agent's own order, so BUY means the agent bought.
+class MultiAssetAgent {
+public:
+    MultiAssetAgent(int id, std::size_t instruments);
+    virtual ~MultiAssetAgent() = default;
+
+    // One snapshot per instrument, indexed like the simulator's books. Runs
+    // in parallel with other agents; must only touch this agent's state.
+    virtual void decide(std::span<const MarketSnapshot> markets, long timestamp,
+                        std::vector<InstrumentIntent>& out) = 0;
+
+    virtual void onFill(std::size_t instrument, const Fill& fill);
+
+    // One ledger per instrument, set by the simulator; not owned
+    void setLedgers(std::vector<const RiskLedger*> ledgers) { this->ledgers = std::move(ledgers); }
+
+    int getId() const { return id; }
+    double getCash() const { return moneyToDouble(cash); }
+    // Cash not reserved by resting orders on any book or committed this step
+    double getAvailableCash() const;
+    // Inventory of `instrument` not offered by resting sells
+    int getAvailableInventory(std::size_t instrument) const;
+    const InstrumentPosition& getPosition(std::size_t instrument) const { return positions[instrument]; }
+    std::size_t getInstrumentCount() const { return positions.size(); }
+
+    double getRealizedPnL() const;
+    // `marketPrices` holds one mark per instrument
+    double getUnrealizedPnL(std::span<const double> marketPrices) const;
+
+    // Called by the simulator once a step's fills are settled
+    void clearCommitments() { committedCash = 0; }
+
+protected:
+    // Counts cash against intents emitted this step, before the book turns
+    // them into reservations, so decide() cannot spend the pool twice
+    void commitCash(double amount) { committedCash += toMoney(amount); }
+
+    int id;
+    Money cash;
+    Money committedCash;
+    std::vector<InstrumentPosition> positions;
+    std::vector<const RiskLedger*> ledgers;
+
+private:
+    void applyTrade(InstrumentPosition& position, int signedQty, Money price);
+};
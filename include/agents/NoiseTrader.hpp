@@ -1,24 +1,32 @@
 #pragma once
 
 #include "agents/Agent.hpp"
-#include <random>
-#include "core/OrderBook.hpp"
+#include "utils/CounterRng.hpp"
+#include <cstdint>
 
 class NoiseTrader : public Agent {
 public:
+    // Seeded from std::random_device
     NoiseTrader(int id);
+    // Reproducible: draws are keyed by (seed, id, timestamp), so the same
+    // master seed gives the same decisions on any platform
+    NoiseTrader(int id, std::uint64_t seed);
 
-    void act(OrderBook& book, long timestamp) override;
+    void decide(const MarketSnapshot& market, long timestamp, std::vector<OrderIntent>& out) override;
+    // Exponentially distributed gaps with the configured mean (see
+    // setWakeInterval); every tick by default
+    long nextWakeup(long now) override;
+    void setWakeInterval(double meanTicks) { wakeInterval = meanTicks; }
+
+    void saveState(BinaryWriter& out) const override;
+    void loadState(BinaryReader& in) override;
+    const char* getType() const override { return "NoiseTrader"; }
 
 private:
     // Order placement strategies
-    bool tryLimitOrder(OrderBook& book, long timestamp);
-    bool tryMarketOrder(OrderBook& book, long timestamp);
-    void placeGuaranteedOrder(OrderBook& book, long timestamp);
+    bool tryLimitOrder(CounterRng& rng, const MarketSnapshot& market, std::vector<OrderIntent>& out);
+    bool tryMarketOrder(CounterRng& rng, const MarketSnapshot& market, std::vector<OrderIntent>& out);
 
-    std::mt19937 rng;
-    std::uniform_real_distribution<> priceDist;
-    std::uniform_int_distribution<> sideDist;
-    std::uniform_int_distribution<> qtyDist;
-    std::uniform_int_distribution<> typeDist;
+    AgentRng rng;
+    double wakeInterval = 1.0;
 };
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "core/Money.hpp"
+#include "core/Order.hpp"
+#include "core/OrderIntent.hpp"
+#include "core/RiskLedger.hpp"
+#include "utils/CounterRng.hpp"
+
+class BinaryWriter;
+class BinaryReader;
+
+// A block of noise traders with consecutive ids, stored as parallel arrays
+// instead of one heap-allocated Agent each. Members follow the same
+// decision rule as NoiseTrader (same distributions and resource checks) and
+// the same fill conventions as Agent::onFill, but:
+//   - each member's RNG is its 64-bit Philox key (seed, id), and a step's
+//     draws are generated for a whole range of members in one pass (drawBatch);
+//   - positions are kept at average cost rather than as FIFO lots, so the
+//     realized/unrealized split can differ from Agent while their sum is the same.
+// Members are not recorded by the StateRecorder.
+class NoiseTraderPopulation {
+public:
+    NoiseTraderPopulation(int firstId, std::size_t count, std::uint64_t seed, double startCash = 10000.0);
+
+    std::size_t size() const { return cash.size(); }
+    int firstId() const { return baseId; }
+    bool owns(int agentId) const {
+        return agentId >= baseId && static_cast<std::size_t>(agentId - baseId) < size();
+    }
+    std::size_t indexOf(int agentId) const { return static_cast<std::size_t>(agentId - baseId); }
+
+    // Generates the random draws of step `timestamp` for members [begin, end)
+    void drawBatch(std::size_t begin, std::size_t end, long timestamp);
+    // Member `index`'s order for this step from its drawn numbers, or false
+    // if it sits the step out. Touches no state but the member's own.
+    bool decide(std::size_t index, const MarketSnapshot& market, OrderIntent& out) const;
+    // drawBatch + decide for [begin, end) against one snapshot; results are
+    // read back with intentOf
+    void decideRange(std::size_t begin, std::size_t end, long timestamp, const MarketSnapshot& market);
+    const OrderIntent* intentOf(std::size_t index) const {
+        return intents[index].quantity > 0 ? &intents[index] : nullptr;
+    }
+
+    // Fill for one of this population's members (see owns)
+    void onFill(const Fill& fill);
+    // Ledger of the book the members trade on; not owned
+    void setLedger(const RiskLedger* ledger) { this->ledger = ledger; }
+
+    // Checkpointing: every member's account and RNG key. Loading requires a
+    // population with the same first id and size.
+    void saveState(BinaryWriter& out) const;
+    void loadState(BinaryReader& in);
+
+    double getCash(std::size_t index) const { return moneyToDouble(cash[index]); }
+    int getInventory(std::size_t index) const { return inventory[index]; }
+    double getAvailableCash(std::size_t index) const {
+        Money reserved = ledger ? ledger->of(baseId + static_cast<int>(index)).cash() : 0;
+        return moneyToDouble(cash[index] - reserved);
+    }
+    double getRealizedPnL(std::size_t index) const { return moneyToDouble(realizedPnL[index]); }
+    double getUnrealizedPnL(std::size_t index, double marketPrice) const {
+        return marketPrice * inventory[index] - moneyToDouble(costBasis[index]);
+    }
+
+private:
+    bool tryLimitOrder(std::size_t index, const MarketSnapshot& market, OrderIntent& out) const;
+    bool tryMarketOrder(std::size_t index, const MarketSnapshot& market, OrderIntent& out) const;
+
+    int baseId;
+
+    // Per-member account state, money in fixed point
+    std::vector<Money> cash;
+    std::vector<int> inventory;
+    std::vector<Money> realizedPnL;
+    std::vector<Money> costBasis;  // signed: sum of entry price * open quantity
+    const RiskLedger* ledger = nullptr;
+
+    // Per-member RNG key and this step's draws: words 0-1 hold the type/side
+    // bits and quantities, words 2-3 the price draw
+    std::vector<philox::Key> keys;
+    std::vector<philox::Block> draws;
+
+    std::vector<OrderIntent> intents;  // decideRange output, quantity 0 = none
+};
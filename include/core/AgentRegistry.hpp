@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+#include "agents/Agent.hpp"
+
+// Dense agent storage with an id -> slot table, so fills can be routed
+// without scanning the population. Agent ids are expected to be small
+// non-negative integers; the table is sized by the largest id seen.
+class AgentRegistry {
+public:
+    static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+    // Returns the new agent's slot. Throws on negative or duplicate ids.
+    std::uint32_t add(std::shared_ptr<Agent> agent);
+
+    std::uint32_t slotOf(int agentId) const {
+        if (agentId < 0 || static_cast<std::size_t>(agentId) >= slotById.size()) return npos;
+        return slotById[agentId];
+    }
+
+    Agent& operator[](std::uint32_t slot) { return *agents[slot]; }
+    const Agent& operator[](std::uint32_t slot) const { return *agents[slot]; }
+
+    std::size_t size() const { return agents.size(); }
+    bool empty() const { return agents.empty(); }
+    const std::vector<std::shared_ptr<Agent>>& all() const { return agents; }
+
+    // Groups `fills` by agent (keeping each agent's fills in order) and hands
+    // every agent its fills as one span. Fills for unknown ids are dropped.
+    void dispatchFills(std::span<const Fill> fills);
+
+private:
+    std::vector<std::shared_ptr<Agent>> agents;
+    std::vector<std::uint32_t> slotById;
+
+    // Scratch reused across steps by dispatchFills
+    std::vector<std::uint32_t> fillSlots;
+    std::vector<std::uint32_t> slotOffsets;
+    std::vector<Fill> groupedFills;
+};
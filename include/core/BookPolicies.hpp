@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include "Order.hpp"
+
+// Compile-time parameters of a BasicOrderBook. A configuration is a type with
+// the same members; each one in use is instantiated at the end of
+// OrderBook.cpp (and its Quantity in PriceLadder.cpp).
+struct DefaultBookConfig {
+    // Price of one of the book's integer ticks; orders arrive priced on
+    // this grid (see BasicOrderBook::limitTick)
+    static constexpr double tickSize = kTickSize;
+    // Price band, in ticks: orders with a limit or stop price outside it are
+    // rejected. The default admits any price from one tick up to $1M.
+    static constexpr Tick minTick = 1;
+    static constexpr Tick maxTick = 100'000'000;
+    // Depth aggregated per price level
+    using Quantity = std::int64_t;
+};
+
+// Side policies: what depends on the side of an incoming order, resolved at
+// compile time so the matching loop has no branches on OrderSide. Accessors
+// take the book's (bid, ask) pair of a member and return this side's half.
+struct BuySide;
+struct SellSide;
+
+struct BuySide {
+    using Opposite = SellSide;
+    static constexpr OrderSide side = OrderSide::BUY;
+    // Limit of an order that takes any price
+    static constexpr Tick kNoLimit = std::numeric_limits<Tick>::max();
+
+    template <typename T>
+    static T& resting(T& bid, T&) { return bid; }
+    template <typename T>
+    static T& opposite(T&, T& ask) { return ask; }
+
+    // Opposite levels, best first
+    template <typename Ladder>
+    static std::optional<Tick> best(const Ladder& asks) { return asks.lowest(); }
+    template <typename Ladder>
+    static std::optional<Tick> next(const Ladder& asks, Tick tick) { return asks.nextHigher(tick); }
+    // Whether an order limited to `limit` trades at `tick`
+    static constexpr bool reaches(Tick tick, Tick limit) { return tick <= limit; }
+};
+
+struct SellSide {
+    using Opposite = BuySide;
+    static constexpr OrderSide side = OrderSide::SELL;
+    static constexpr Tick kNoLimit = std::numeric_limits<Tick>::min();
+
+    template <typename T>
+    static T& resting(T&, T& ask) { return ask; }
+    template <typename T>
+    static T& opposite(T& bid, T&) { return bid; }
+
+    template <typename Ladder>
+    static std::optional<Tick> best(const Ladder& bids) { return bids.highest(); }
+    template <typename Ladder>
+    static std::optional<Tick> next(const Ladder& bids, Tick tick) { return bids.nextLower(tick); }
+    static constexpr bool reaches(Tick tick, Tick limit) { return tick >= limit; }
+};
+
+// Calls f(BuySide{}) or f(SellSide{}): the one runtime branch on the side,
+// after which everything is compiled for it
+template <typename F>
+decltype(auto) withSide(OrderSide side, F&& f) {
+    if (side == OrderSide::BUY) return f(BuySide{});
+    return f(SellSide{});
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include "core/MarketSimulator.hpp"
+#include "utils/Statistics.hpp"
+
+struct EnsembleConfig {
+    std::size_t replicas = 100;
+    std::uint64_t masterSeed = 0;
+    // Replica-level parallelism; 0 uses every hardware thread
+    unsigned threads = 0;
+    // Template for every replica. `seed` is replaced per replica and
+    // `recordingPath` by `recordingDir`.
+    SimulatorConfig simulator;
+    // One recording per replica (replica_<n>.bin) if set; none otherwise
+    std::string recordingDir;
+    // Range of the per-agent PnL histograms used for quantiles
+    double pnlLow = -5000.0;
+    double pnlHigh = 5000.0;
+    std::size_t pnlBins = 400;
+};
+
+struct AgentTypeResults {
+    RunningStats pnl;
+    Histogram pnlHistogram;
+};
+
+// Aggregates over all replicas; nothing per replica is kept
+struct EnsembleResults {
+    std::size_t replicas = 0;
+    std::map<std::string, AgentTypeResults> pnlByType;  // total PnL per agent, by Agent::getType
+    RunningStats finalPrice;
+    RunningStats pathLow;
+    RunningStats pathHigh;
+    RunningStats stepVolatility;  // stddev of per-step log returns, per replica
+    RunningStats trades;          // executed trades per replica
+    double elapsedSeconds = 0.0;
+
+    void print(std::ostream& out) const;
+};
+
+// Runs many independent MarketSimulator replicas on a WorkStealingPool.
+// Replica n is seeded with deriveSeed(masterSeed, n), so a run is
+// reproducible replica by replica regardless of scheduling.
+class EnsembleRunner {
+public:
+    // Adds a replica's agents; called on the worker running that replica
+    using Populate = std::function<void(MarketSimulator& sim, std::uint64_t replicaSeed)>;
+
+    EnsembleRunner(const EnsembleConfig& config, Populate populate);
+
+    EnsembleResults run();
+
+private:
+    void runReplica(std::size_t replica, EnsembleResults& into);
+
+    EnsembleConfig config;
+    Populate populate;
+};
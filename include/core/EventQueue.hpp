@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using SimTime = std::uint64_t;
+
+enum class EventType : std::uint8_t {
+    Wakeup,        // target: agent slot
+    OrderArrival,  // payload: pending intent index
+    Timer,         // payload: timer callback index
+    Record         // periodic state recording
+};
+
+struct Event {
+    SimTime time;
+    EventType type;
+    std::uint32_t target = 0;
+    std::uint32_t payload = 0;
+};
+
+// Calendar queue for integer event times. Events within `horizon` ticks of
+// the current time sit in a timing wheel: one bucket per tick, appended in
+// push order, with an occupancy bitmap to find the next busy tick. Events
+// further out wait in a binary heap and move onto the wheel as the window
+// reaches them. Events at equal times pop in the order they were pushed,
+// so a run is deterministic.
+class EventQueue {
+public:
+    // `horizon` is rounded up to a power of two (and at least 64)
+    explicit EventQueue(std::size_t horizon = 4096);
+
+    // Requires event.time >= now()
+    void push(const Event& event);
+    // Earliest pending event in (time, push order); false once empty
+    bool pop(Event& out);
+    // Time of the event pop() would return next, without removing it
+    bool peekTime(SimTime& time);
+
+    bool empty() const { return size() == 0; }
+    std::size_t size() const { return wheelCount + far.size(); }
+    // Time of the last popped (or peeked) event
+    SimTime now() const { return current; }
+
+private:
+    struct FarEvent {
+        Event event;
+        std::uint64_t sequence;
+    };
+
+    std::size_t bucketOf(SimTime time) const { return static_cast<std::size_t>(time) & (buckets.size() - 1); }
+    void pushToWheel(const Event& event);
+    // Moves the cursor to the earliest pending event; false if there is none
+    bool advance();
+    // Moves every far event inside [current, current + horizon) onto the wheel
+    void migrate();
+    // Next busy tick after `current` on the wheel, or false if the wheel is empty
+    bool nextBusy(SimTime& time) const;
+
+    std::vector<std::vector<Event>> buckets;
+    std::vector<std::uint64_t> occupancy;  // bit per bucket
+    std::size_t wheelCount = 0;
+    std::size_t cursor = 0;                // next unread event in the current bucket
+    SimTime current = 0;
+
+    std::vector<FarEvent> far;             // min-heap on (time, sequence)
+    std::uint64_t farSequence = 0;
+};
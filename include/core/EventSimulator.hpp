@@ -0,0 +1,84 @@
+#pragma once
+
+#include "core/AgentRegistry.hpp"
+#include "core/EventQueue.hpp"
+#include "core/OrderBook.hpp"
+#include "core/OrderIntent.hpp"
+#include "utils/StateRecorder.hpp"
+#include "agents/Agent.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct EventSimulatorConfig {
+    // Events at or after this time are not run
+    SimTime endTime = 50;
+    // Ticks between an agent's decision and its order reaching the book;
+    // per-agent overrides via EventSimulator::setLatency
+    SimTime orderLatency = 0;
+    // State recording period in ticks; 0 disables recording
+    SimTime recordInterval = 1;
+    std::string recordingPath = "logs/simulation.bin";
+    // Ticks covered by the event wheel; later events wait in the far heap
+    std::size_t wheelHorizon = 4096;
+    SelfTradePolicy selfTradePolicy = SelfTradePolicy::Skip;
+};
+
+// Event-driven alternative to MarketSimulator's lock-step loop. Agents only
+// run when they are woken: at a wakeup an agent decides against the current
+// book, its orders are scheduled to arrive after its latency, and it names
+// its next wakeup time (Agent::nextWakeup). Fills go to their agents as soon
+// as an order arrival produces them. Idle agents cost nothing between wakeups.
+class EventSimulator {
+public:
+    using TimerCallback = std::function<void(EventSimulator&)>;
+
+    explicit EventSimulator(const EventSimulatorConfig& config);
+
+    // Adds an agent whose first wakeup is at `firstWakeup`
+    void addAgent(std::shared_ptr<Agent> agent, SimTime firstWakeup = 0);
+    void setLatency(int agentId, SimTime latency);
+    // Runs `callback` once at `time`
+    void scheduleTimer(SimTime time, TimerCallback callback);
+
+    // Processes events until the queue is empty or endTime is reached
+    void run();
+    // Processes the next event; false when there is nothing left to run
+    bool step();
+    // Flushes and closes the state recording
+    void finish();
+    void printSummary() const;
+
+    SimTime now() const { return events.now(); }
+    const OrderBook& getOrderBook() const { return orderBook; }
+    const AgentRegistry& getAgents() const { return agents; }
+    long getTradeCount() const { return tradeCount; }
+    std::uint64_t getEventCount() const { return eventCount; }
+
+private:
+    void wake(std::uint32_t slot, SimTime time);
+    void arrive(std::uint32_t intentIndex, SimTime time);
+    void deliverFills();
+    void record(SimTime time);
+
+    EventSimulatorConfig config;
+    OrderBook orderBook;
+    AgentRegistry agents;
+    EventQueue events;
+    std::unique_ptr<StateRecorder> recorder;
+
+    std::vector<SimTime> latencyBySlot;
+
+    // Orders in flight, recycled through a free list
+    std::vector<OrderIntent> inFlight;
+    std::vector<std::uint32_t> freeInFlight;
+    std::vector<OrderIntent> decisions;  // scratch for one wakeup
+
+    std::vector<TimerCallback> timers;
+
+    long tradeCount = 0;
+    std::uint64_t eventCount = 0;
+    double elapsedSeconds = 0.0;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "core/AgentRegistry.hpp"
+#include "core/OrderBook.hpp"
+#include "core/OrderGateway.hpp"
+#include "agents/Agent.hpp"
+
+struct GatewaySimulatorConfig {
+    int steps = 50;
+    // Agent threads; agents are split across them in contiguous blocks
+    unsigned shards = 2;
+    // See GatewayConfig::sequenced. Sequenced runs with seeded agents repeat
+    // exactly; free-running ones depend on thread timing.
+    bool sequenced = false;
+    // Free-running: batches a shard may send past the last one matched for it
+    int maxLag = 2;
+    std::size_t ringCapacity = 1 << 14;
+    int matchingCpu = -1;
+    SelfTradePolicy selfTradePolicy = SelfTradePolicy::Skip;
+};
+
+// Agents on shard threads, the book on a matching thread behind an
+// OrderGateway. Each step a shard decides for its agents against the last
+// book snapshot it was sent, streams the orders into its ring and closes
+// the batch. Free-running shards go on to the next step while up to
+// `maxLag` of their batches are unmatched, so deciding overlaps matching;
+// sequenced shards first wait until the previous batch is matched and its
+// fills delivered. Agents have no
+// ledger in this mode: the book's reservations belong to the matching thread.
+class GatewaySimulator {
+public:
+    explicit GatewaySimulator(const GatewaySimulatorConfig& config);
+
+    // Before run()
+    void addAgent(std::shared_ptr<Agent> agent);
+
+    void run();
+    void printSummary() const;
+
+    // Only between runs
+    const OrderBook& getOrderBook() const { return orderBook; }
+    const OrderGateway& getGateway() const { return gateway; }
+
+private:
+    struct alignas(64) Shard {
+        AgentRegistry agents;
+        std::vector<OrderIntent> intents;
+        std::vector<Fill> fills;  // received since the last batch closed
+        MarketSnapshot market;
+        long closedBatch = -1;
+    };
+
+    void runShard(std::size_t index);
+    // Takes the reports waiting for a shard; fills go to its agents when a
+    // batch closes
+    void drain(Shard& shard, OrderGateway::Port& port);
+
+    GatewaySimulatorConfig config;
+    OrderBook orderBook;
+    OrderGateway gateway;
+    std::vector<std::shared_ptr<Agent>> pending;  // added, not yet sharded
+    std::vector<Shard> shards;
+    std::atomic<std::size_t> finishedShards{0};
+    double elapsedSeconds = 0.0;
+};
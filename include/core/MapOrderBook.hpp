@@ -0,0 +1,45 @@
+#pragma once
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <optional>
+#include "Order.hpp"
+
+// Original std::map-keyed book. Kept as a reference implementation for
+// benchmarks and cross-checking; the simulator runs on OrderBook. Keeps no
+// reservation ledger.
+class MapOrderBook {
+public:
+    MapOrderBook();
+
+    void addLimitOrder(const Order& order);
+    std::vector<Fill> matchMarketOrder(const Order& marketOrder);
+    bool cancelOrder(int orderId);
+
+    std::optional<double> bestBid() const;
+    std::optional<double> bestAsk() const;
+
+    void printBook() const;
+
+    const std::vector<Fill>& getRecentFills() const;
+    void clearFills();
+    double getMidPrice() const;
+    double getLastTradePrice() const;
+    
+    // Action tracking methods
+    bool wasActionTakenByAgent(int agentId) const;
+    void clearAgentActionFlag();
+    
+    // Access methods for order books
+    const std::map<Tick, std::deque<Order>>& getAsks() const { return asks; }
+    const std::map<Tick, std::deque<Order>>& getBids() const { return bids; }
+
+private:
+    std::map<Tick, std::deque<Order>> bids; // tick -> orders (BUY)
+    std::map<Tick, std::deque<Order>> asks; // tick -> orders (SELL)
+    std::map<int, Order> idLookup;
+    std::vector<Fill> recentFills;
+    Tick lastTradeTick;
+    int actionTakenByAgentId;
+};
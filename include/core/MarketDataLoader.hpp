@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "core/OrderPool.hpp"
+#include "core/OrderBookFwd.hpp"
+#include "utils/MappedFile.hpp"
+#include "utils/OpenAddressMap.hpp"
+
+// Order-by-order market data in the framing and field layout of NASDAQ
+// TotalView-ITCH 5.0. Each message is a 2-byte big-endian length followed
+// by the body; every body starts with a one-character type, stock locate
+// (2), tracking number (2) and a 6-byte nanoseconds-since-midnight
+// timestamp. Integers are big-endian and prices carry four implied decimals.
+namespace itch {
+
+inline constexpr std::size_t kHeaderSize = 11;
+
+// Body sizes of the messages the loader reads; all others are skipped
+inline constexpr std::size_t kStockDirectorySize = 39;  // 'R': stock(8) ...
+inline constexpr std::size_t kAddSize = 36;             // 'A': ref(8) side(1) shares(4) stock(8) price(4)
+inline constexpr std::size_t kAddAttributedSize = 40;   // 'F': as 'A', then MPID(4)
+inline constexpr std::size_t kExecutedSize = 31;        // 'E': ref(8) shares(4) match(8)
+inline constexpr std::size_t kExecutedPriceSize = 36;   // 'C': as 'E', then printable(1) price(4)
+inline constexpr std::size_t kCancelSize = 23;          // 'X': ref(8) shares(4)
+inline constexpr std::size_t kDeleteSize = 19;          // 'D': ref(8)
+inline constexpr std::size_t kReplaceSize = 35;         // 'U': old ref(8) new ref(8) shares(4) price(4)
+
+} // namespace itch
+
+struct MarketDataStats {
+    std::uint64_t messages = 0;       // every message read, skipped ones included
+    std::uint64_t adds = 0;
+    std::uint64_t executions = 0;
+    std::uint64_t cancels = 0;        // partial cancels
+    std::uint64_t deletes = 0;
+    std::uint64_t replaces = 0;
+    std::uint64_t skipped = 0;        // other message types or other instruments
+    std::uint64_t unknownOrders = 0;  // references to orders added before the file starts
+};
+
+// Streams an ITCH-like file (see namespace itch) into an OrderBook. The file
+// is memory-mapped and parsed in place; the only per-order state is an
+// order reference -> handle table, which grows only when the number of live
+// orders reaches a new peak. Adds rest without matching (the exchange
+// already matched them), executions become OrderBook::executeOrder, and a
+// replace cancels the old order and adds the new one at the back of its
+// level, as on the exchange.
+class MarketDataLoader {
+public:
+    // Owner id of loaded orders; fills against them reach no agent
+    static constexpr int kAgentId = -2;
+
+    // Maps `path`; with a symbol, only that instrument's messages are
+    // applied. Throws std::runtime_error if the file cannot be opened.
+    explicit MarketDataLoader(const std::string& path, std::string_view symbol = {});
+
+    // Applies messages to `book` up to (not including) the first one stamped
+    // at or after `endNanos`. Returns false once the file is exhausted. The
+    // book's pending fills are discarded as it goes; keep passing the same
+    // book. Throws std::runtime_error on a truncated message.
+    bool replayUntil(OrderBook& book, std::uint64_t endNanos = std::numeric_limits<std::uint64_t>::max());
+
+    bool done() const { return offset >= data.size(); }
+    const MarketDataStats& getStats() const { return stats; }
+
+private:
+    // Handle of a loaded order by reference; empty if unknown
+    OrderHandle handleOf(std::uint64_t ref) const {
+        const OrderHandle* handle = orders.find(ref);
+        return handle ? *handle : OrderHandle{};
+    }
+    // False for messages of other instruments
+    bool accepts(char type, const std::byte* body);
+    void apply(OrderBook& book, char type, const std::byte* body, std::uint64_t timestamp);
+    void add(OrderBook& book, std::uint64_t ref, OrderSide side, int shares,
+             std::uint64_t price, long timestamp);
+
+    MappedFile file;
+    std::span<const std::byte> data;
+    std::size_t offset = 0;
+    std::array<char, 8> symbol{};  // space-padded, as in the messages
+    bool filtered = false;
+    int locate = -1;               // the symbol's stock locate, once seen
+    OpenAddressMap<std::uint64_t, OrderHandle> orders;  // order reference -> handle
+    MarketDataStats stats;
+};
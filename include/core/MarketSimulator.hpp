@@ -1,29 +1,136 @@
 #pragma once
 
 #include "core/OrderBook.hpp"
-#include "utils/CsvLogger.hpp"
+#include "core/AgentRegistry.hpp"
+#include "core/MarketDataLoader.hpp"
+#include "core/OrderIntent.hpp"
+#include "core/OrderJournal.hpp"
+#include "utils/Profiler.hpp"
+#include "utils/StateRecorder.hpp"
+#include "utils/ThreadPool.hpp"
 #include "agents/Agent.hpp"
+#include "agents/NoiseTraderPopulation.hpp"
+#include <cstdint>
 #include <memory>
+#include <ostream>
+#include <span>
+#include <string>
 #include <vector>
 
+struct SimulatorConfig {
+    int steps = 50;
+    // 0: agents act one after another on the live book.
+    // N > 0: two-phase steps. Agents decide in parallel on N threads against
+    // a snapshot taken at the start of the step, then their intents are
+    // applied to the book in an order shuffled from `seed`. Only agents that
+    // implement Agent::decide take part in this mode.
+    unsigned decisionThreads = 0;
+    std::uint64_t seed = 0;
+    // What the book does when an agent's order meets its own resting orders
+    SelfTradePolicy selfTradePolicy = SelfTradePolicy::Skip;
+    // Binary state recording; empty disables it
+    std::string recordingPath = "logs/simulation.bin";
+    // Order-flow journal for journal_replay; empty disables it. A run
+    // restored from a checkpoint journals from the restored book, so only a
+    // fresh run's journal replays into an empty book.
+    std::string journalPath;
+    // Per-phase step timing, printed after run(); ignored when profiling is
+    // compiled out (ABMS_PROFILING=0)
+    bool profile = false;
+    // Also write the profile as JSON here (implies `profile`)
+    std::string profileJsonPath;
+};
+
 class MarketSimulator {
 public:
     // Constructor requires the total simulation steps.
     MarketSimulator(int steps);
+    MarketSimulator(const SimulatorConfig& config);
     
     // Add an agent to the simulation.
     void addAgent(std::shared_ptr<Agent> agent);
+    // Add a block of array-backed noise traders. At most one per simulator;
+    // its id range must not overlap any agent's id.
+    void addPopulation(std::shared_ptr<NoiseTraderPopulation> population);
     
     // Run the full simulation.
     void run();
     
     // Execute one simulation step.
     void stepSimulation();
-    
+
+    // For drivers that step the simulation themselves instead of run()
+    bool isFinished() const { return timestamp >= maxSteps; }
+    // Flushes and closes the state recording and the order journal
+    void finish();
+
+    // Final state of the run: counts, timing and per-agent PnL.
+    void printSummary() const;
+    // Phase timings and book counters; prints nothing unless profiling
+    void printProfile(std::ostream& out);
+
+    const Profiler& getProfiler() const { return profiler; }
+
+    // Writes the full simulation state (book, agents, population, step and
+    // trade count) to `path`
+    void saveCheckpoint(const std::string& path) const;
+    // Restores a checkpoint into a simulator set up with the same agents
+    // (ids and types) and population. Agents added that the checkpoint does
+    // not know keep their fresh state, so a fork can introduce new ones.
+    // Throws std::runtime_error on a malformed or mismatched file.
+    void loadCheckpoint(const std::string& path);
+
+    // Plays historical order flow into the book up to `endNanos` (see
+    // MarketDataLoader::replayUntil), so agents start against a real book.
+    // Call before the first step; loaded orders belong to no agent.
+    void seedFromMarketData(MarketDataLoader& loader, std::uint64_t endNanos);
+
+    // Price used to mark an agent's open position to market
+    double markPrice(const Agent& agent) const;
+
+    const OrderBook& getOrderBook() const { return orderBook; }
+    const AgentRegistry& getAgents() const { return agents; }
+    const NoiseTraderPopulation* getPopulation() const { return population.get(); }
+    long getTradeCount() const { return tradeCount; }
+    int getTimestamp() const { return timestamp; }
+
 private:
+    // Where each agent's intents landed during the decision phase
+    struct IntentRange {
+        std::uint32_t chunk;
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+
+    // Phase one: parallel decide() into per-thread buffers
+    void decideInParallel();
+    // Phase two: apply intents agent by agent in a seed-shuffled order
+    void applyIntents();
+    // Sends the pending batch to the book, its fills to stepFills
+    void flushBatch();
+    // Population members' turn on the live book (sequential mode)
+    void actPopulation();
+    // Hands each fill to its agent or population member
+    void dispatchFills(std::span<const Fill> fills);
+    // End-of-step recording and per-step tracing
+    void report();
+
+    SimulatorConfig config;
     int timestamp;
     int maxSteps;
+    long tradeCount;
+    double elapsedSeconds = 0.0;
     OrderBook orderBook;
-    std::vector<std::shared_ptr<Agent>> agents;
-    std::unique_ptr<CsvLogger> logger;
+    AgentRegistry agents;
+    std::shared_ptr<NoiseTraderPopulation> population;
+    std::unique_ptr<StateRecorder> recorder;
+    std::unique_ptr<OrderJournal> journal;
+    Profiler profiler;
+
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<std::vector<OrderIntent>> intentBuffers;  // one per chunk
+    std::vector<IntentRange> intentRanges;                // one per agent slot
+    std::vector<std::uint32_t> matchOrder;                // agent slots, then population members
+    std::vector<Order> batch;                             // LIMIT and MARKET intents awaiting submitBatch
+    std::vector<Fill> stepFills;                          // fills of the step's two-phase apply
 };
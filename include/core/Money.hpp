@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include "core/Order.hpp"
+
+// Account money is fixed point: whole micro-units of the currency. A fill at
+// an integer tick moves a whole number of them, so cash and PnL add up
+// exactly and the same way on every platform. Doubles only appear at the
+// reporting boundary (getters, snapshots, printed summaries).
+using Money = std::int64_t;
+inline constexpr Money kMoneyScale = 1'000'000;  // units per 1.0
+
+// Units per tick of a price grid. Books check that their tick is a whole
+// number of units (BasicOrderBook::kMoneyPerTick).
+constexpr Money moneyPerTick(double tickSize) { return static_cast<Money>(tickSize * kMoneyScale + 0.5); }
+constexpr bool isWholeMoney(double tickSize) {
+    double error = tickSize * kMoneyScale - static_cast<double>(moneyPerTick(tickSize));
+    return moneyPerTick(tickSize) > 0 && error < 1e-6 && error > -1e-6;
+}
+inline constexpr Money kMoneyPerTick = moneyPerTick(kTickSize);  // the default kTickSize grid
+static_assert(isWholeMoney(kTickSize));
+
+inline Money toMoney(double amount) { return std::llround(amount * kMoneyScale); }
+inline double moneyToDouble(Money amount) { return static_cast<double>(amount) / kMoneyScale; }
+// A fill's price in money, at the scale of the book that filled it
+inline Money priceOf(const Fill& fill) { return fill.price * fill.moneyPerTick; }
+
+// Part of an open position's cost basis that closing `closed` of
+// `position` (same sign, |closed| <= |position|) takes out, at average
+// cost: costBasis * closed / position, rounded once toward zero. The basis
+// is split into whole multiples of `position` and a remainder so no product
+// can overflow, and closing all of it takes the whole basis, so no rounding
+// residue is left behind.
+inline Money averageCost(Money costBasis, int position, int closed) {
+    if (closed == position) return costBasis;
+    return costBasis / position * closed + costBasis % position * closed / position;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core/OrderBook.hpp"
+#include "core/OrderIntent.hpp"
+#include "agents/MultiAssetAgent.hpp"
+#include "utils/ThreadPool.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct MultiSimulatorConfig {
+    int steps = 50;
+    std::size_t instruments = 2;
+    // Worker threads shared by the decision and matching phases; books are
+    // sharded across them in contiguous blocks
+    unsigned threads = 1;
+    std::uint64_t seed = 0;
+    SelfTradePolicy selfTradePolicy = SelfTradePolicy::Skip;  // for every book
+};
+
+// N order books stepped in lock-step. Each step: agents decide in parallel
+// against per-instrument snapshots, intents are routed to their books, every
+// book matches its own intents on a worker thread, and after that barrier
+// fills are settled into agents' per-instrument accounts in instrument order.
+class MultiMarketSimulator {
+public:
+    explicit MultiMarketSimulator(const MultiSimulatorConfig& config);
+
+    void addAgent(std::shared_ptr<MultiAssetAgent> agent);
+
+    void run();
+    void stepSimulation();
+    void printSummary() const;
+
+    const OrderBook& getBook(std::size_t instrument) const { return books[instrument]; }
+
+private:
+    void decideInParallel();
+    void routeIntents();
+    void matchInParallel();
+    void settle();
+
+    MultiSimulatorConfig config;
+    int timestamp;
+    long tradeCount;
+    double elapsedSeconds = 0.0;
+
+    std::vector<OrderBook> books;
+    std::vector<std::shared_ptr<MultiAssetAgent>> agents;
+    std::vector<std::uint32_t> slotById;
+    ThreadPool pool;
+
+    std::vector<MarketSnapshot> snapshots;
+    std::vector<std::vector<InstrumentIntent>> intentBuffers;   // per decision chunk
+    std::vector<std::vector<OrderIntent>> bookIntents;          // per instrument
+    std::vector<std::vector<Fill>> executions;                  // per instrument
+};
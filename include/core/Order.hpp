@@ -1,24 +1,69 @@
 #pragma once
 
+#include <cmath>
+#include <cstdint>
 #include <string>
 
-enum class OrderSide { BUY, SELL };
+enum class OrderSide : std::uint8_t { BUY, SELL };
 
+// How OrderBook::submitOrder treats an order
+enum class OrderType : std::uint8_t {
+    Limit,      // matches up to `price`, the rest rests
+    Market,     // matches at any price, the rest is dropped
+    IOC,        // immediate-or-cancel: matches up to `price`, the rest is dropped
+    FOK,        // fill-or-kill: matches all of it up to `price`, or is rejected untouched
+    Stop,       // parked until the last trade reaches its stop price, then a market order
+    StopLimit,  // parked until the last trade reaches its stop price, then a limit order at `price`
+    Iceberg,    // limit order showing at most its display quantity at a time
+};
+
+// What the book does when an incoming order would trade with a resting order
+// of the same agent
+enum class SelfTradePolicy : std::uint8_t {
+    Skip,             // leave the resting order and match past it
+    CancelResting,    // cancel the resting order, keep matching
+    CancelAggressor,  // cancel the rest of the incoming order
+    DecrementBoth,    // take the smaller quantity off both, without a trade
+};
+
+// Prices inside the book are integer ticks; doubles only exist at the edges.
+using Tick = std::int64_t;
+inline constexpr double kTickSize = 0.01;
+
+inline Tick priceToTicks(double price) { return std::llround(price / kTickSize); }
+inline double ticksToPrice(Tick ticks) { return static_cast<double>(ticks) * kTickSize; }
+
+// Orders and fills are 32-byte records: two to a cache line in the book's
+// pool and in fill buffers. Prices are ticks; anything an order type needs
+// beyond the record travels separately in OrderParams.
 struct Order {
     int id;
     int agentId;
-    double price;
-    int quantity;
+    Tick price;  // limit, on the book's tick grid; unused for Market and Stop
+    std::int32_t quantity;
     OrderSide side;
-    long timestamp;
+    OrderType type = OrderType::Limit;
+    std::int64_t timestamp;
+};
+static_assert(sizeof(Order) == 32);
+
+// Parameters of Stop, StopLimit and Iceberg orders (see OrderBook::submitOrder)
+struct OrderParams {
+    Tick stopPrice = 0;                // Stop and StopLimit: trigger tick
+    std::int32_t displayQuantity = 0;  // Iceberg
 };
 
+// One side of an execution. `side` is the side of the receiving agent's own
+// order, so BUY means that agent bought. `price` is on the grid of the book
+// that filled it; `moneyPerTick` says what one of its ticks is worth in
+// account money (see Money.hpp).
 struct Fill {
     int agentId;
-    double price;
-    int quantity;
+    std::int32_t quantity;
+    Tick price;
     OrderSide side;
-    long timestamp;
-    bool isReservation = false;
-    bool isCancellation = false;
+    bool isAggressor = false;  // the incoming order's side of a match
+    std::int32_t moneyPerTick;
+    std::int64_t timestamp;
 };
+static_assert(sizeof(Fill) == 32);
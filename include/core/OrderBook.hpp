@@ -1,42 +1,290 @@
 #pragma once
 
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <deque>
+#include <span>
 #include <vector>
+#include <concepts>
+#include <limits>
 #include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "BookPolicies.hpp"
+#include "Money.hpp"
 #include "Order.hpp"
+#include "OrderBookFwd.hpp"
+#include "OrderPool.hpp"
+#include "PriceLadder.hpp"
+#include "RiskLedger.hpp"
+#include "TriggerBook.hpp"
+
+class BinaryWriter;
+class BinaryReader;
+class OrderJournal;
+
+// Activity counters; only maintained when ABMS_PROFILING is compiled in
+struct BookStats {
+    std::uint64_t ordersPlaced = 0;    // orders of any type accepted
+    std::uint64_t fills = 0;           // passive/aggressor pairs
+    std::uint64_t cancels = 0;         // cancel and reduce requests applied
+    std::uint64_t levelsTouched = 0;   // price levels visited while sweeping
+    std::uint64_t selfTrades = 0;      // own resting orders an aggressor met (see SelfTradePolicy)
+    std::uint64_t stopsTriggered = 0;  // Stop and StopLimit orders released by the last trade
+    std::uint64_t bandRejects = 0;     // orders with a limit or stop price outside the band
+    std::uint64_t fokRejects = 0;      // FOK orders the book could not fill
+};
+
+// One aggregated price level (L2)
+struct DepthLevel {
+    double price;
+    std::int64_t quantity;
+    std::uint32_t orders;
+};
+
+// Non-owning callback that receives fills as they happen: any callable
+// taking `const Fill&`, or a vector to append to. Two pointers, passed by
+// value; the callable or vector must outlive the call it is passed to. A
+// default-constructed sink discards fills.
+class FillSink {
+public:
+    FillSink() = default;
+    template <typename F>
+        requires std::invocable<F&, const Fill&>
+    FillSink(F& callback)
+        : context(&callback),
+          emit([](void* c, const Fill& fill) { (*static_cast<F*>(c))(fill); }) {}
+    FillSink(std::vector<Fill>& out)
+        : context(&out),
+          emit([](void* c, const Fill& fill) { static_cast<std::vector<Fill>*>(c)->push_back(fill); }) {}
+
+    void operator()(const Fill& fill) const {
+        if (emit) emit(context, fill);
+    }
+
+private:
+    void* context = nullptr;
+    void (*emit)(void*, const Fill&) = nullptr;
+};
+
+// Fixed-size top-of-book view filled by OrderBook::depthSnapshot
+template <std::size_t N>
+struct BookDepth {
+    std::array<DepthLevel, N> bids;  // best (highest) first
+    std::array<DepthLevel, N> asks;  // best (lowest) first
+    std::size_t bidLevels = 0;
+    std::size_t askLevels = 0;
+};
+
+// Limit order book on an integer-tick price ladder. Same public interface as
+// MapOrderBook. Orders arrive priced in ticks; limitTick snaps a price to
+// the book's grid in the trader's favour (buys down, sells up). Resting
+// orders live in an OrderPool; addLimitOrder returns a handle for O(1)
+// cancel and reduce.
+// Reservations for resting orders are kept in the book's RiskLedger; the
+// fill stream only carries executions. An aggressor never trades with its
+// own resting orders; the SelfTradePolicy decides what happens instead.
+// Stop orders wait in a TriggerBook outside the ladder and are released,
+// after the call that moved the last trade price, in trigger order; orders
+// they set off fire in turn. Icebergs rest with only their displayed slice
+// on the level, and a fully filled slice is replaced from the hidden reserve
+// at the back of the queue.
+//
+// The core is compiled per Config (see DefaultBookConfig): tick size, price
+// band and depth type are constants, and matching is generated once per
+// side from the side policies, so the sweep never branches on OrderSide.
+// `OrderBook` is the default configuration.
+template <typename Config>
+class BasicOrderBook {
+    static_assert(Config::tickSize > 0.0, "tick size must be positive");
+    static_assert(0 < Config::minTick && Config::minTick <= Config::maxTick, "empty price band");
+    static_assert(std::is_signed_v<typename Config::Quantity>, "depth must be signed");
+    static_assert(isWholeMoney(Config::tickSize)
+                  && moneyPerTick(Config::tickSize) <= std::numeric_limits<std::int32_t>::max(),
+                  "tick size must be a whole number of money units");
 
-class OrderBook {
 public:
-    OrderBook();
+    using Quantity = typename Config::Quantity;
+    using Ladder = BasicPriceLadder<Quantity>;
 
-    void addLimitOrder(const Order& order);
+    // Value of one tick of this book in account money; carried by its fills
+    // and used by its ledger
+    static constexpr Money kMoneyPerTick = moneyPerTick(Config::tickSize);
+
+    BasicOrderBook();
+
+    // The book's tick grid, for pricing orders and reading prices back
+    static Tick toTicks(double price) { return std::llround(price / Config::tickSize); }
+    static double toPrice(Tick tick) { return static_cast<double>(tick) * Config::tickSize; }
+    // Snaps a limit price to the grid without making it more aggressive
+    static Tick limitTick(OrderSide side, double price) {
+        double ticks = price / Config::tickSize;
+        return static_cast<Tick>(side == OrderSide::BUY ? std::floor(ticks + 1e-9) : std::ceil(ticks - 1e-9));
+    }
+
+    // Returns a handle to the resting remainder (empty if fully filled).
+    // The submitter's fills of the crossing part also go to `executions`.
+    OrderHandle addLimitOrder(const Order& order, FillSink executions);
+    OrderHandle addLimitOrder(const Order& order, std::vector<Fill>* executions = nullptr) {
+        return executions ? addLimitOrder(order, FillSink(*executions)) : addLimitOrder(order, FillSink());
+    }
+    // Places an order of any OrderType; a limit or stop price outside the
+    // band is rejected like an unfillable FOK. Returns a handle to what the book
+    // keeps of it: the resting remainder of a Limit, Iceberg or triggered
+    // StopLimit order, or a parked Stop/StopLimit order (kept until it
+    // fires; cancelOrder and reduceOrder work on it). Market, IOC and FOK
+    // orders leave nothing. FOK checks displayed depth first and is dropped
+    // without touching the book if it cannot fill; under the CancelAggressor
+    // and DecrementBoth policies the check stops at the sender's own orders.
+    // The submitter's fills go to `executions`; the fills of stops it sets
+    // off only to getRecentFills(). Stop, StopLimit and Iceberg orders take
+    // their stop price and display quantity from `params`.
+    OrderHandle submitOrder(const Order& order, const OrderParams& params, FillSink executions = {});
+    OrderHandle submitOrder(const Order& order, FillSink executions = {}) {
+        return submitOrder(order, OrderParams{}, executions);
+    }
+    // Sweeps the opposite side; returns the quantity filled. Nothing is
+    // allocated apart from amortized growth of getRecentFills().
+    int matchMarketOrder(const Order& marketOrder, FillSink executions);
     std::vector<Fill> matchMarketOrder(const Order& marketOrder);
+    // Applies `orders` in sequence, each as matchMarketOrder or submitOrder
+    // (without params) would. Every fill of the batch, passive, aggressor and
+    // those of stops it sets off, goes to `fills` in book order and none to
+    // getRecentFills(), so a match copies each fill once and allocates
+    // nothing in the book.
+    void submitBatch(std::span<const Order> orders, FillSink fills);
     bool cancelOrder(int orderId);
+    bool cancelOrder(OrderHandle handle);
+    // Takes `quantity` off a resting or parked order, cancelling it if
+    // nothing is left. An iceberg loses hidden reserve first.
+    bool reduceOrder(OrderHandle handle, int quantity);
+    // Fills up to `quantity` of a resting order against an aggressor outside
+    // the book (historical executions): a passive fill for its owner, and the
+    // last trade price moves as for a match
+    bool executeOrder(OrderHandle handle, int quantity, long timestamp);
+
+    // Resting or parked order behind a handle, or nullptr once it is
+    // filled/cancelled. An iceberg shows its displayed slice.
+    const Order* findOrder(OrderHandle handle) const;
 
     std::optional<double> bestBid() const;
     std::optional<double> bestAsk() const;
 
+    // Copies up to bids.size() / asks.size() levels per side, best first,
+    // from the per-level aggregates; no allocation. Returns the number of
+    // levels written per side.
+    std::pair<std::size_t, std::size_t> depthSnapshot(std::span<DepthLevel> bids,
+                                                      std::span<DepthLevel> asks) const;
+    template <std::size_t N>
+    void depthSnapshot(BookDepth<N>& out) const {
+        std::tie(out.bidLevels, out.askLevels) = depthSnapshot(out.bids, out.asks);
+    }
+
     void printBook() const;
 
+    // Executions since the last clearFills(), other than those of a
+    // submitBatch, in book order: each match adds
+    // the resting order's fill, then the aggressor's (isAggressor)
     const std::vector<Fill>& getRecentFills() const;
     void clearFills();
     double getMidPrice() const;
     double getLastTradePrice() const;
-    
+
     // Action tracking methods
     bool wasActionTakenByAgent(int agentId) const;
     void clearAgentActionFlag();
-    
-    // Access methods for order books
-    const std::map<double, std::deque<Order>>& getAsks() const { return asks; }
-    const std::map<double, std::deque<Order>>& getBids() const { return bids; }
+
+    // Applies to orders submitted from now on. Default: Skip.
+    void setSelfTradePolicy(SelfTradePolicy policy);
+    SelfTradePolicy getSelfTradePolicy() const { return selfTradePolicy; }
+
+    const BookStats& getStats() const { return stats; }
+    // Reservations of every agent with orders resting in this book
+    const RiskLedger& getLedger() const { return ledger; }
+
+    // Records every later add, match, cancel and reduce, with the fills they
+    // produce, to `journal` (nullptr stops), starting with the self-trade
+    // policy. Attach before the first order for a journal that replays from
+    // an empty book. Not owned.
+    void setJournal(OrderJournal* journal);
+
+    // Checkpointing: resting orders (in priority order), parked stops, the id counter,
+    // last trade price and counters. Pending fills are not saved. Loading
+    // replaces the whole book and rebuilds the ledger from the orders;
+    // handles from before the load go stale. The journal and self-trade
+    // policy are settings of the book and are kept.
+    void saveState(BinaryWriter& out) const;
+    void loadState(BinaryReader& in);
+
+    // Price-keyed copies of each side, built on demand (debugging/tests only)
+    std::map<double, std::deque<Order>> getAsks() const { return toMap(asks); }
+    std::map<double, std::deque<Order>> getBids() const { return toMap(bids); }
 
 private:
-    std::map<double, std::deque<Order>> bids; // price -> orders (BUY)
-    std::map<double, std::deque<Order>> asks; // price -> orders (SELL)
-    std::map<int, Order> idLookup;
+    struct SweepResult {
+        int filled;
+        int remaining;  // what is left to rest; 0 if self-trade prevention cancelled it
+    };
+
+    // Places a submitted order (not Market)
+    OrderHandle place(const Order& order, const OrderParams& params, FillSink executions);
+    // Matches `aggressor` against the opposite side up to `limit` (no limit
+    // for market orders), through the sweep for its side
+    SweepResult sweep(const Order& aggressor, std::optional<Tick> limit, FillSink executions);
+    template <typename Side>
+    SweepResult sweep(const Order& aggressor, Tick limit, FillSink executions);
+    // Whether the displayed depth up to `limit` covers a FOK order
+    bool canFill(const Order& order, Tick limit) const;
+    template <typename Side>
+    bool canFill(const Order& order, Tick limit) const;
+    // Puts an order (id already assigned) at the back of its level, with
+    // `reserve` more hidden behind it in slices of `display`
+    OrderIndex rest(const Order& order, int reserve = 0, int display = 0);
+    // Puts an allocated node on the level at its tick and reserves it
+    void link(OrderIndex index);
+    // Takes `quantity` off the resting order at `index` on `level`. An
+    // emptied iceberg slice is refilled from the reserve at the back of the
+    // level; anything else is unlinked and freed once empty. Returns whether
+    // the order is still resting; leaves an emptied level to the caller.
+    // `Side` is the resting order's.
+    template <typename Side>
+    bool takeQuantity(OrderIndex index, typename Ladder::Level& level, int quantity);
+    // Same, for the order behind `index` wherever it rests; frees its level if emptied
+    void takeQuantity(OrderIndex index, int quantity);
+    // Stop orders: parking (id already assigned), removal, and releasing the
+    // ones the last trade price has reached, stamped `timestamp`
+    OrderIndex park(const Order& order, Tick stopTick);
+    void unpark(OrderIndex index);
+    void fireStops(long timestamp);
+    void trigger(OrderIndex index, long timestamp);
+    std::map<double, std::deque<Order>> toMap(const Ladder& ladder) const;
+    // Hands a fill to the running batch's sink, or keeps it in recentFills
+    void publish(const Fill& fill) {
+        if (batchFills) (*batchFills)(fill);
+        else recentFills.push_back(fill);
+    }
+
+    static bool inBand(Tick tick) { return tick >= Config::minTick && tick <= Config::maxTick; }
+
+    Ladder bids; // tick -> orders (BUY)
+    Ladder asks; // tick -> orders (SELL)
+    LevelOwnerIndex bidOwners;
+    LevelOwnerIndex askOwners;
+    OrderPool pool;
+    OrderIdIndex idLookup;
+    TriggerBook stops;
+    std::vector<OrderIndex> triggered;  // scratch for fireStops
+    int nextOrderId;
     std::vector<Fill> recentFills;
-    double lastTradePrice;
+    const FillSink* batchFills = nullptr;  // set during submitBatch
+    Tick lastTradeTick;
     int actionTakenByAgentId;
+    BookStats stats;
+    RiskLedger ledger;
+    SelfTradePolicy selfTradePolicy = SelfTradePolicy::Skip;
+    OrderJournal* journal = nullptr;
 };
@@ -0,0 +1,7 @@
+#pragma once
+
+// Forward declarations for headers that only pass the book around
+struct DefaultBookConfig;
+template <typename Config>
+class BasicOrderBook;
+using OrderBook = BasicOrderBook<DefaultBookConfig>;
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "core/OrderBook.hpp"
+#include "core/OrderIntent.hpp"
+#include "utils/Profiler.hpp"
+#include "utils/SpscRing.hpp"
+
+struct GatewayConfig {
+    std::size_t producers = 1;
+    std::size_t ringCapacity = 1 << 14;  // messages per ring
+    // Sequenced: batch N is applied producer by producer, in producer order,
+    // and closed for everyone at once, so a run does not depend on thread
+    // timing. Free-running: messages are applied as they arrive and each
+    // producer's batch is closed as soon as its own marker is read.
+    bool sequenced = false;
+    // Core to pin the matching thread to; -1 leaves it to the scheduler
+    int matchingCpu = -1;
+};
+
+// Producer -> matching thread
+struct GatewayRequest {
+    enum class Kind : std::uint8_t {
+        Order,     // `intent`, stamped with `batch`
+        EndOfBatch // the producer has sent everything for `batch`
+    };
+    Kind kind;
+    long batch;
+    std::uint64_t sentNanos;  // steady clock, for the latency histograms
+    OrderIntent intent;
+};
+
+// Matching thread -> producer
+struct ExecutionReport {
+    enum class Kind : std::uint8_t {
+        Fill,       // `fill`, for an agent routed to this producer
+        EndOfBatch  // `batch` is matched; `market` is the book after it
+    };
+    Kind kind;
+    long batch;
+    Fill fill;
+    MarketSnapshot market;
+};
+
+// Order entry in front of an OrderBook owned by one matching thread. Each
+// producer thread gets a pair of SPSC rings: requests in, execution reports
+// out, so the order path takes no locks. A producer whose request ring is
+// full should keep draining its report ring while it retries, since the
+// matching thread may be waiting for room there.
+class OrderGateway {
+public:
+    // One producer's end of the rings. Call only from that producer's thread.
+    class Port {
+    public:
+        explicit Port(std::size_t capacity) : requests(capacity), reports(capacity) {}
+
+        bool trySend(const GatewayRequest& request) { return requests.tryPush(request); }
+        bool tryReceive(ExecutionReport& report) { return reports.tryPop(report); }
+
+    private:
+        friend class OrderGateway;
+        SpscRing<GatewayRequest> requests;
+        SpscRing<ExecutionReport> reports;
+    };
+
+    // The book is only touched by the matching thread between start() and
+    // stop(). Not owned.
+    OrderGateway(OrderBook& book, const GatewayConfig& config);
+    ~OrderGateway();
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    // Sends the fills of `agentId` to `producer`'s report ring; fills of
+    // agents never routed are dropped. Before start().
+    void route(int agentId, std::size_t producer);
+
+    Port& port(std::size_t producer) { return *ports[producer]; }
+    std::size_t producers() const { return ports.size(); }
+
+    void start();
+    // Applies whatever the producers have sent, then joins the matching
+    // thread. In sequenced mode every producer must have closed its last batch.
+    void stop();
+
+    static std::uint64_t nowNanos();
+
+    // Valid once stopped
+    std::uint64_t orderCount() const { return orders; }
+    std::uint64_t tradeCount() const { return trades; }
+    // Send to the start of matching, and matching alone, per order
+    const LatencyHistogram& queueLatency() const { return queued; }
+    const LatencyHistogram& matchLatency() const { return matching; }
+
+private:
+    void matchingLoop();
+    // Applies one order and sends its fills to their producers
+    void apply(const GatewayRequest& request);
+    void closeBatch(std::size_t producer, long batch);
+    void send(std::size_t producer, const ExecutionReport& report);
+
+    OrderBook& book;
+    GatewayConfig config;
+    std::vector<std::unique_ptr<Port>> ports;
+    std::vector<std::uint32_t> producerById;
+
+    std::thread matcher;
+    std::atomic<bool> stopping{false};
+
+    std::uint64_t orders = 0;
+    std::uint64_t trades = 0;
+    LatencyHistogram queued;
+    LatencyHistogram matching;
+};
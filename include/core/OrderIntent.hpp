@@ -0,0 +1,48 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <vector>
+#include "core/Order.hpp"
+#include "core/OrderBook.hpp"
+
+// Read-only view of the book handed to agents during the decision phase
+struct MarketSnapshot {
+    std::optional<double> bestBid;
+    std::optional<double> bestAsk;
+    double midPrice;
+    double lastTradePrice;
+
+    static MarketSnapshot of(const OrderBook& book);
+};
+
+// ORDER goes through OrderBook::submitOrder with any OrderType
+enum class IntentType { LIMIT, MARKET, CANCEL, ORDER };
+
+// An order an agent wants placed; applied to the book after all agents
+// have decided.
+struct OrderIntent {
+    IntentType type;
+    int agentId;
+    OrderSide side;
+    double price;     // LIMIT, and ORDER types with a limit
+    int quantity;
+    int orderId = -1; // CANCEL only
+    // ORDER only
+    OrderType orderType = OrderType::Limit;
+    double stopPrice = 0.0;
+    int displayQuantity = 0;
+};
+
+// The plain order a LIMIT or MARKET intent places at `timestamp`, for
+// OrderBook::submitBatch; nothing for the other types
+std::optional<Order> asOrder(const OrderIntent& intent, long timestamp);
+
+// Applies one intent to the book at `timestamp`. Every fill goes to the
+// book's recent fills; the submitting agent's own are also copied to
+// `executions`.
+void submitIntent(OrderBook& book, const OrderIntent& intent, long timestamp, FillSink executions = {});
+
+// Applies intents in order, as repeated submitIntent calls
+void submitIntents(OrderBook& book, std::span<const OrderIntent> intents, long timestamp,
+                   FillSink executions = {});
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <vector>
+#include "core/Order.hpp"
+#include "core/OrderBookFwd.hpp"
+
+// On-disk layout of an order-flow journal. Native byte order; a file is a
+// header followed by fixed-size records in call order. Each Limit or Market
+// record is followed by the Trade records its sweep produced. Orders removed
+// by self-trade prevention are not recorded; replaying under the recorded
+// policy removes them again.
+namespace journal {
+
+inline constexpr char kMagic[8] = {'A', 'B', 'M', 'S', 'J', 'R', 'N', '\0'};
+inline constexpr std::uint32_t kVersion = 3;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+};
+
+enum class RecordType : std::uint8_t {
+    Limit,      // addLimitOrder, or submitOrder of any type but Market
+    Market,     // matchMarketOrder
+    Cancel,     // cancelOrder, or a reduce that took the whole order
+    Reduce,     // reduceOrder that left part of the order resting
+    Trade,      // one passive fill of the preceding Limit/Market order
+    Execute,    // executeOrder: a resting order filled from outside the book
+    SelfTrade,  // the book's SelfTradePolicy (in `quantity`) from here on
+    Params,     // stop tick (`price`) and display quantity of the next Limit record
+};
+
+// Limit/Market: the incoming order (price is the snapped limit tick, 0 for
+// market orders; `orderType` is its OrderType). Stop, StopLimit and Iceberg
+// orders are preceded by a Params record. Cancel/Reduce: the target order id and the quantity taken
+// off; `ok` is 0 for a cancel of an unknown id. Trade and Execute: the
+// passive side.
+// Cancels carry no time of their own and are stamped with the latest order
+// timestamp.
+struct Record {
+    RecordType type;
+    std::uint8_t side;  // OrderSide
+    std::uint8_t ok;
+    std::uint8_t orderType;  // OrderType; Limit/Market records only
+    std::int32_t agentId;
+    std::int64_t timestamp;
+    Tick price;
+    std::int32_t orderId;
+    std::int32_t quantity;
+};
+static_assert(sizeof(Record) == 32);
+
+} // namespace journal
+
+// Appends every order-flow call made on an OrderBook (see
+// OrderBook::setJournal) to a binary file. Records are buffered and written
+// in blocks on the calling thread.
+class OrderJournal {
+public:
+    // Throws std::runtime_error if the file cannot be created
+    OrderJournal(const std::string& filename, std::size_t bufferRecords = 1 << 14);
+    ~OrderJournal();
+
+    OrderJournal(const OrderJournal&) = delete;
+    OrderJournal& operator=(const OrderJournal&) = delete;
+
+    // Limit records carry the order's tick, Market records 0
+    void recordOrder(journal::RecordType type, const Order& order, const OrderParams& params = {});
+    void recordTrade(const Order& passive, int quantity, long timestamp);
+    void recordCancel(int orderId, int agentId, int quantity, bool whole, bool ok);
+    void recordExecute(const Order& order, int quantity, long timestamp);
+    void recordSelfTradePolicy(SelfTradePolicy policy);
+
+    std::uint64_t recordCount() const { return written + buffer.size(); }
+    // Writes out buffered records and closes the file
+    void close();
+
+private:
+    void append(const journal::Record& record) {
+        buffer.push_back(record);
+        if (buffer.size() == capacity) flush();
+    }
+    void flush();
+
+    std::FILE* out;
+    std::size_t capacity;
+    std::vector<journal::Record> buffer;
+    std::uint64_t written = 0;
+    long lastTimestamp = 0;
+};
+
+struct ReplayResult {
+    std::uint64_t records = 0;
+    std::uint64_t orders = 0;      // Limit and Market records applied
+    std::uint64_t cancels = 0;     // Cancel and Reduce records applied
+    std::uint64_t trades = 0;      // passive fills produced by the replay, executions included
+    std::uint64_t mismatches = 0;  // recorded and replayed fills that differ
+    // Index of the first record that disagreed, or `records` if none did
+    std::uint64_t firstMismatch = 0;
+};
+
+// Feeds a journal (the whole file, header included) straight into `book`,
+// which must be in the state the recording started from, normally empty.
+// With `verify`, the passive fills and cancel results the replay produces
+// (and execution results) are compared with the recorded ones; without it Trade records are skipped
+// and the loop does nothing but drive the book. Throws std::runtime_error on
+// a malformed journal.
+ReplayResult replayJournal(std::span<const std::byte> data, OrderBook& book, bool verify = true);
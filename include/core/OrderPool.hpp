@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Order.hpp"
+#include "utils/OpenAddressMap.hpp"
+
+using OrderIndex = std::uint32_t;
+inline constexpr OrderIndex kNullOrder = static_cast<OrderIndex>(-1);
+
+// Stable reference to a resting order. The generation makes handles to
+// filled or cancelled orders go stale instead of aliasing a reused slot.
+struct OrderHandle {
+    OrderIndex slot = kNullOrder;
+    std::uint32_t generation = 0;
+
+    explicit operator bool() const { return slot != kNullOrder; }
+};
+
+// Head/tail of an intrusive FIFO of pool nodes (one per price level)
+struct OrderQueue {
+    OrderIndex head = kNullOrder;
+    OrderIndex tail = kNullOrder;
+
+    bool empty() const { return head == kNullOrder; }
+};
+
+// Slab of resting orders linked into per-level queues. Freed slots go on a
+// free list and are handed out again, so once the slab has reached its
+// high-water mark placing and removing orders does not allocate.
+class OrderPool {
+public:
+    struct Node {
+        Order order;
+        Tick tick;
+        std::int32_t reserve;  // hidden iceberg quantity behind order.quantity
+        std::int32_t display;  // iceberg slice size
+        OrderIndex prev;
+        OrderIndex next;
+        std::uint32_t generation;
+    };
+
+    OrderIndex allocate(const Order& order, Tick tick);
+    void release(OrderIndex index);
+
+    Node& operator[](OrderIndex index) { return nodes[index]; }
+    const Node& operator[](OrderIndex index) const { return nodes[index]; }
+
+    OrderHandle handleOf(OrderIndex index) const { return {index, nodes[index].generation}; }
+    bool isLive(OrderHandle handle) const {
+        return handle.slot < nodes.size() && nodes[handle.slot].generation == handle.generation;
+    }
+
+    void pushBack(OrderQueue& queue, OrderIndex index);
+    void unlink(OrderQueue& queue, OrderIndex index);
+
+    std::size_t size() const { return live; }
+    void reserve(std::size_t count) { nodes.reserve(count); }
+
+private:
+    std::vector<Node> nodes;
+    OrderIndex freeHead = kNullOrder;  // threaded through Node::next
+    std::size_t live = 0;
+};
+
+// Order id -> pool slot map for cancel-by-id
+class OrderIdIndex {
+public:
+    void insert(int orderId, OrderIndex index) { slots.insert(orderId, index); }
+    OrderIndex find(int orderId) const {
+        const OrderIndex* index = orderId > 0 ? slots.find(orderId) : nullptr;
+        return index ? *index : kNullOrder;
+    }
+    void erase(int orderId) {
+        if (orderId > 0) slots.erase(orderId);
+    }
+
+private:
+    OpenAddressMap<int, OrderIndex, 0> slots{1024};  // ids start at 1
+};
+
+// One agent's share of a price level
+struct OwnedQuantity {
+    std::int64_t quantity = 0;
+    std::uint32_t orders = 0;
+};
+
+// (agent id, tick) -> OwnedQuantity for one side of the book, so the matcher
+// knows how much of a level belongs to the aggressor without walking the
+// queue. An entry lives while the agent has orders at the level. Negative
+// agent ids are not tracked.
+class LevelOwnerIndex {
+public:
+    // Adds `quantity` and `orders` (either may be negative) to the share
+    void update(int agentId, Tick tick, std::int64_t quantity, int orders) {
+        if (agentId < 0) return;
+        std::uint64_t key = keyOf(agentId, tick);
+        OwnedQuantity& share = shares[key];
+        share.quantity += quantity;
+        share.orders += orders;
+        if (share.orders == 0) shares.erase(key);
+    }
+    OwnedQuantity find(int agentId, Tick tick) const {
+        const OwnedQuantity* share = agentId >= 0 ? shares.find(keyOf(agentId, tick)) : nullptr;
+        return share ? *share : OwnedQuantity{};
+    }
+
+private:
+    static std::uint64_t keyOf(int agentId, Tick tick) {
+        return (static_cast<std::uint64_t>(agentId) << 32) | static_cast<std::uint32_t>(tick);
+    }
+
+    OpenAddressMap<std::uint64_t, OwnedQuantity> shares{256};
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+#include "Order.hpp"
+#include "OrderPool.hpp"
+
+// One side of the book: a fixed-size window of price levels around the touch,
+// indexed by tick offset from a movable base. Occupied levels in the window
+// are tracked in a two-level bitmap (one bit per level, one summary bit per
+// 64-level word), so the best price is a couple of bit scans instead of a
+// tree walk. Levels outside the window (stub quotes, deep resting orders
+// left behind by a moving market) live in a sparse overflow map, so memory
+// follows the number of levels rather than the span of prices they cover.
+// `Quantity` is the type of the per-level depth aggregate; the types in use
+// are instantiated in PriceLadder.cpp.
+template <typename Quantity>
+class BasicPriceLadder {
+public:
+    struct Level {
+        OrderQueue queue;  // resting orders in time priority, stored in the book's OrderPool
+        // Aggregates kept up to date by the book on add, fill and cancel
+        Quantity totalQuantity = 0;
+        std::uint32_t orderCount = 0;
+    };
+
+    // Which end of the ladder is the touch: Highest for bids, Lowest for asks
+    enum class Touch { Lowest, Highest };
+
+    BasicPriceLadder(Touch touch, Tick centerTick, std::size_t capacity = 2048);
+
+    bool empty() const { return occupied == 0; }
+    std::size_t levelCount() const { return occupied; }
+
+    std::optional<Tick> lowest() const;
+    std::optional<Tick> highest() const;
+    std::optional<Tick> nextLower(Tick tick) const;   // highest occupied tick below `tick`
+    std::optional<Tick> nextHigher(Tick tick) const;  // lowest occupied tick above `tick`
+
+    // Returns the level at `tick` and marks it occupied. A tick outside the
+    // window recenters it when it becomes the new touch, and otherwise goes
+    // to the overflow map. May move other levels.
+    Level& acquire(Tick tick);
+    // Marks a level empty once its last order is gone, recentering the
+    // window if the touch moves out of it. May move other levels.
+    void release(Tick tick);
+
+    Level* find(Tick tick);
+    const Level* find(Tick tick) const;
+
+private:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    bool inWindow(Tick tick) const;
+    std::optional<Tick> touchTick() const;
+    std::size_t findNextSet(std::size_t pos) const;
+    std::size_t findPrevSet(std::size_t pos) const;
+    void setBit(std::size_t pos);
+    void clearBit(std::size_t pos);
+    void recenter(Tick center);
+
+    Touch touch;
+    Tick base;
+    std::vector<Level> levels;           // the window, never resized
+    std::vector<std::uint64_t> words;    // bit per level
+    std::vector<std::uint64_t> summary;  // bit per non-zero word
+    std::map<Tick, Level> overflow;      // occupied levels outside the window
+    std::size_t occupied;
+};
+
+using PriceLadder = BasicPriceLadder<std::int64_t>;
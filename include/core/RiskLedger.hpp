@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "core/Money.hpp"
+#include "core/Order.hpp"
+
+// What an account has committed to its resting orders. Buy cash is kept in
+// whole money units, so reserving and releasing the same order cancels exactly.
+struct Reservation {
+    Money buyCash = 0;          // sum of price * quantity over resting buys
+    std::int64_t longQty = 0;   // resting buy quantity
+    std::int64_t shortQty = 0;  // resting sell quantity
+
+    Money cash() const { return buyCash; }
+};
+
+// Per-account reservations, kept up to date by the OrderBook as orders rest,
+// fill and are cancelled, so an account's available cash and inventory are
+// current the moment the book changes. Accounts are indexed by agent id;
+// negative ids (orders that belong to no agent) are not tracked.
+class RiskLedger {
+public:
+    // `moneyPerTick`: the value of one tick of the owning book's grid
+    explicit RiskLedger(Money moneyPerTick = kMoneyPerTick) : moneyPerTick(moneyPerTick) {}
+
+    void reserve(int accountId, OrderSide side, int quantity, Tick tick) {
+        if (accountId < 0) return;
+        if (static_cast<std::size_t>(accountId) >= accounts.size()) accounts.resize(accountId + 1);
+        apply(accounts[accountId], side, quantity, tick);
+    }
+    void release(int accountId, OrderSide side, int quantity, Tick tick) {
+        if (accountId < 0 || static_cast<std::size_t>(accountId) >= accounts.size()) return;
+        apply(accounts[accountId], side, -quantity, tick);
+    }
+
+    // All zero for accounts with nothing resting
+    const Reservation& of(int accountId) const {
+        static const Reservation none;
+        if (accountId < 0 || static_cast<std::size_t>(accountId) >= accounts.size()) return none;
+        return accounts[accountId];
+    }
+
+    void clear() { accounts.clear(); }
+
+private:
+    void apply(Reservation& account, OrderSide side, int quantity, Tick tick) const {
+        if (side == OrderSide::BUY) {
+            account.buyCash += tick * moneyPerTick * quantity;
+            account.longQty += quantity;
+        } else {
+            account.shortQty += quantity;
+        }
+    }
+
+    Money moneyPerTick;
+    std::vector<Reservation> accounts;
+};
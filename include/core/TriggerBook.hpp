@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <vector>
+#include "Order.hpp"
+#include "OrderPool.hpp"
+
+// Parked stop orders (pool slots) keyed by trigger tick. Buy stops fire once
+// the last trade is at or above their tick, sell stops at or below, so a
+// price move costs O(log n) plus the stops it fires; untouched stops are
+// never visited.
+class TriggerBook {
+public:
+    void add(OrderSide side, Tick trigger, OrderIndex index);
+    // False if the stop is not parked at `trigger`
+    bool remove(OrderSide side, Tick trigger, OrderIndex index);
+
+    // Removes the stops a last trade at `last` fires and appends them to
+    // `out`: nearest trigger first, then in the order they were parked
+    void collect(Tick last, std::vector<OrderIndex>& out);
+
+    bool empty() const { return buys.empty() && sells.empty(); }
+    std::size_t size() const { return buys.size() + sells.size(); }
+
+    // Visits every parked stop as f(side, trigger, index); buys, then sells,
+    // each in the order collect() would fire them
+    template <typename F>
+    void forEach(F&& f) const {
+        for (const auto& [trigger, index] : buys) f(OrderSide::BUY, trigger, index);
+        for (const auto& [trigger, index] : sells) f(OrderSide::SELL, trigger, index);
+    }
+
+    void clear() {
+        buys.clear();
+        sells.clear();
+    }
+
+private:
+    std::multimap<Tick, OrderIndex> buys;                      // fire when last >= key
+    std::multimap<Tick, OrderIndex, std::greater<Tick>> sells; // fire when last <= key
+};
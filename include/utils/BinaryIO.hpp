@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Flat native-byte-order serialization for checkpoints and journals.
+// Values are copied bytewise; there is no padding or alignment between them.
+class BinaryWriter {
+public:
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        append(&value, sizeof(T));
+    }
+
+    template <typename T>
+    void writeArray(std::span<const T> values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write<std::uint64_t>(values.size());
+        append(values.data(), values.size_bytes());
+    }
+
+    // Length-prefixed opaque bytes (e.g. a nested writer's output)
+    void writeBlock(std::span<const std::byte> block) { writeArray<std::byte>(block); }
+
+    void writeString(std::string_view text) {
+        write<std::uint32_t>(static_cast<std::uint32_t>(text.size()));
+        append(text.data(), text.size());
+    }
+
+    const std::vector<std::byte>& bytes() const { return buffer; }
+    void clear() { buffer.clear(); }
+
+    // Writes the buffer to `path`, replacing the file; throws on failure
+    void saveTo(const std::string& path) const;
+
+private:
+    void append(const void* data, std::size_t size) {
+        const auto* first = static_cast<const std::byte*>(data);
+        buffer.insert(buffer.end(), first, first + size);
+    }
+
+    std::vector<std::byte> buffer;
+};
+
+// Bounds-checked reader over a byte range; throws std::runtime_error if the
+// data ends early.
+class BinaryReader {
+public:
+    explicit BinaryReader(std::span<const std::byte> data) : data(data) {}
+
+    template <typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void readArray(std::vector<T>& out) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        auto count = read<std::uint64_t>();
+        if (count > remaining() / sizeof(T)) fail();
+        out.resize(static_cast<std::size_t>(count));
+        const std::byte* bytes = take(out.size() * sizeof(T));
+        if (!out.empty()) std::memcpy(out.data(), bytes, out.size() * sizeof(T));
+    }
+
+    // Bytes written by writeBlock, as a view into the underlying data
+    std::span<const std::byte> readBlock() {
+        auto size = read<std::uint64_t>();
+        if (size > remaining()) fail();
+        return {take(static_cast<std::size_t>(size)), static_cast<std::size_t>(size)};
+    }
+
+    std::string readString() {
+        auto size = read<std::uint32_t>();
+        const auto* chars = reinterpret_cast<const char*>(take(size));
+        return std::string(chars, size);
+    }
+
+    std::size_t remaining() const { return data.size() - offset; }
+    std::size_t position() const { return offset; }
+
+private:
+    const std::byte* take(std::size_t size) {
+        if (size > remaining()) fail();
+        const std::byte* at = data.data() + offset;
+        offset += size;
+        return at;
+    }
+
+    [[noreturn]] static void fail() { throw std::runtime_error("Binary data ends early"); }
+
+    std::span<const std::byte> data;
+    std::size_t offset = 0;
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Counter-based random numbers (Philox4x32-10, Salmon et al. 2011). A draw is
+// a pure function of (key, counter), so any agent's numbers at any step can
+// be computed directly, in any order and on any thread, and come out the
+// same on every compiler and standard library. Keys are derived from
+// (master seed, agent id); the counter holds (step, sub-stream, block).
+
+namespace philox {
+
+using Key = std::array<std::uint32_t, 2>;
+using Block = std::array<std::uint32_t, 4>;
+
+inline constexpr std::uint32_t kMul0 = 0xD2511F53u;
+inline constexpr std::uint32_t kMul1 = 0xCD9E8D57u;
+inline constexpr std::uint32_t kWeyl0 = 0x9E3779B9u;
+inline constexpr std::uint32_t kWeyl1 = 0xBB67AE85u;
+
+inline Block philox4x32(Block ctr, Key key) {
+    for (int round = 0; round < 10; ++round) {
+        std::uint64_t p0 = static_cast<std::uint64_t>(kMul0) * ctr[0];
+        std::uint64_t p1 = static_cast<std::uint64_t>(kMul1) * ctr[2];
+        ctr = Block{static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+                    static_cast<std::uint32_t>(p1),
+                    static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+                    static_cast<std::uint32_t>(p0)};
+        key[0] += kWeyl0;
+        key[1] += kWeyl1;
+    }
+    return ctr;
+}
+
+// 53-bit uniform double in [0, 1) from two 32-bit words
+inline double toUnit(std::uint32_t hi, std::uint32_t lo) {
+    std::uint64_t bits = (static_cast<std::uint64_t>(hi) << 32) | lo;
+    return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+// Integer in [lo, hi] by 32-bit multiply-shift. No rejection step, so batch
+// and scalar draws stay in lockstep; the bias is below (range / 2^32).
+inline int toRange(std::uint32_t word, int lo, int hi) {
+    auto range = static_cast<std::uint64_t>(static_cast<std::int64_t>(hi) - lo + 1);
+    return lo + static_cast<int>((word * range) >> 32);
+}
+
+} // namespace philox
+
+// Sequential view of one (key, step, sub-stream): successive calls walk the
+// block counter. Small enough to create on the stack for each decision.
+class CounterRng {
+public:
+    CounterRng(philox::Key key, std::uint64_t step, std::uint32_t substream = 0)
+        : key(key),
+          counter{0, static_cast<std::uint32_t>(step), static_cast<std::uint32_t>(step >> 32), substream} {}
+
+    std::uint32_t nextU32() {
+        if (used == 4) refill();
+        return buffer[used++];
+    }
+    std::uint64_t nextU64() {
+        std::uint64_t hi = nextU32();
+        return (hi << 32) | nextU32();
+    }
+
+    // Uniform in [0, 1)
+    double uniform() {
+        std::uint32_t hi = nextU32();
+        return philox::toUnit(hi, nextU32());
+    }
+    // Uniform in [low, high)
+    double uniform(double low, double high) { return low + (high - low) * uniform(); }
+    // Uniform integer in [lo, hi]
+    int uniformInt(int lo, int hi) { return philox::toRange(nextU32(), lo, hi); }
+
+private:
+    void refill() {
+        buffer = philox::philox4x32(counter, key);
+        ++counter[0];
+        used = 0;
+    }
+
+    philox::Key key;
+    philox::Block counter;
+    philox::Block buffer{};
+    int used = 4;
+};
+
+// The only per-agent RNG state: the agent's key
+class AgentRng {
+public:
+    AgentRng(std::uint64_t masterSeed, std::uint64_t agentId);
+    explicit AgentRng(philox::Key key) : key(key) {}
+
+    CounterRng at(std::uint64_t step, std::uint32_t substream = 0) const {
+        return CounterRng(key, step, substream);
+    }
+    const philox::Key& getKey() const { return key; }
+
+private:
+    philox::Key key;
+};
+
+// Batch generation. Each fills `out` with exactly the values the matching
+// sequence of CounterRng calls would return. Blocks are computed kLanes at a
+// time with the words of each block in separate arrays (structure of
+// arrays), so every Philox round is the same arithmetic across the lanes
+// and compiles to vector multiplies; a partial last group is padded.
+namespace philox {
+
+inline constexpr std::size_t kLanes = 8;
+
+// Key for (master seed, agent id), as used by AgentRng
+Key deriveKey(std::uint64_t masterSeed, std::uint64_t agentId);
+
+// Block `block` of (keys[i], step, substream) for every i: one 128-bit draw
+// per key, for stepping a whole population at once
+void generateBlocks(std::span<const Key> keys, std::uint64_t step, std::uint32_t substream,
+                    std::uint32_t block, std::span<Block> out);
+
+// out.size() uniform doubles in [0, 1) from one stream
+void uniformBatch(const Key& key, std::uint64_t step, std::uint32_t substream, std::span<double> out);
+
+// out.size() integers in [lo, hi] from one stream
+void uniformIntBatch(const Key& key, std::uint64_t step, std::uint32_t substream,
+                     int lo, int hi, std::span<int> out);
+
+} // namespace philox
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+// Leveled, categorised tracing. Statements above ABMS_LOG_MAX_LEVEL are
+// discarded at compile time (benchmark builds use -1 to drop everything);
+// the rest are filtered at runtime by logging::setLevel/setCategories.
+#ifndef ABMS_LOG_MAX_LEVEL
+#define ABMS_LOG_MAX_LEVEL 4
+#endif
+
+enum class LogLevel : int { Error = 0, Warn = 1, Info = 2, Debug = 3, Trace = 4 };
+
+enum class LogCategory : std::uint32_t {
+    General = 1u << 0,
+    Book    = 1u << 1,
+    Agent   = 1u << 2,
+    Fill    = 1u << 3,
+    Step    = 1u << 4,
+    All     = 0xFFFFFFFFu
+};
+
+namespace logging {
+
+void setLevel(LogLevel level);
+LogLevel level();
+void setCategories(std::uint32_t mask);
+std::uint32_t categories();
+
+bool enabled(LogLevel level, LogCategory category);
+// stderr for warnings and errors, stdout otherwise
+std::ostream& stream(LogLevel level);
+
+} // namespace logging
+
+#define ABMS_LOG_ENABLED(level, category) \
+    (static_cast<int>(level) <= ABMS_LOG_MAX_LEVEL && logging::enabled(level, category))
+
+// Usage: ABMS_LOG(LogLevel::Debug, LogCategory::Agent, "Agent " << id << " placed\n");
+#define ABMS_LOG(level, category, expr)                              \
+    do {                                                             \
+        if constexpr (static_cast<int>(level) <= ABMS_LOG_MAX_LEVEL) { \
+            if (logging::enabled(level, category)) {                 \
+                logging::stream(level) << expr;                      \
+            }                                                        \
+        }                                                            \
+    } while (0)
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file. Memory-mapped on POSIX systems, so large
+// files load without a copy; read into memory elsewhere.
+class MappedFile {
+public:
+    // Throws std::runtime_error if the file cannot be opened
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::span<const std::byte> bytes() const { return {data, size}; }
+
+private:
+    const std::byte* data = nullptr;
+    std::size_t size = 0;
+    bool mapped = false;
+    std::vector<std::byte> fallback;
+};
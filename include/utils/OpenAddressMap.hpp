@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Hash map from an integer key to a small value, in one flat array. Linear
+// probing with backward-shift deletion, so erases leave no tombstones and
+// the table only reallocates when the number of entries reaches a new peak
+// (it doubles past half full). `kEmpty` marks a free slot and cannot be
+// used as a key.
+template <typename Key, typename Value, Key kEmpty = static_cast<Key>(-1)>
+class OpenAddressMap {
+    static_assert(std::is_integral_v<Key>, "keys are integers");
+
+public:
+    // `capacity` is the initial slot count, a power of two
+    explicit OpenAddressMap(std::size_t capacity = 1024)
+        : slots(capacity, Slot{kEmpty, Value{}}) {}
+
+    Value* find(Key key) {
+        std::size_t i = probe(key);
+        return slots[i].key == key ? &slots[i].value : nullptr;
+    }
+    const Value* find(Key key) const {
+        std::size_t i = probe(key);
+        return slots[i].key == key ? &slots[i].value : nullptr;
+    }
+
+    // The value under `key`, value-initialized if it was not there
+    Value& operator[](Key key) {
+        std::size_t i = probe(key);
+        if (slots[i].key == key) return slots[i].value;
+        if ((count + 1) * 2 > slots.size()) {
+            grow();
+            i = probe(key);
+        }
+        ++count;
+        slots[i] = Slot{key, Value{}};
+        return slots[i].value;
+    }
+
+    void insert(Key key, const Value& value) { (*this)[key] = value; }
+
+    // Returns whether `key` was there
+    bool erase(Key key) {
+        std::size_t i = probe(key);
+        if (slots[i].key != key) return false;
+
+        // Backward-shift the rest of the probe run into the hole
+        std::size_t mask = slots.size() - 1;
+        std::size_t hole = i;
+        for (std::size_t j = (i + 1) & mask; slots[j].key != kEmpty; j = (j + 1) & mask) {
+            std::size_t h = home(slots[j].key);
+            // Move j into the hole unless its home lies cyclically in (hole, j]
+            bool stays = (hole <= j) ? (hole < h && h <= j) : (hole < h || h <= j);
+            if (!stays) {
+                slots[hole] = slots[j];
+                hole = j;
+            }
+        }
+        slots[hole] = Slot{kEmpty, Value{}};
+        --count;
+        return true;
+    }
+
+    std::size_t size() const { return count; }
+
+private:
+    struct Slot {
+        Key key;
+        Value value;
+    };
+
+    std::size_t home(Key key) const {
+        // Fibonacci hashing; slot count is a power of two
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ULL) >> 32)
+               & (slots.size() - 1);
+    }
+
+    // The slot holding `key`, or the free slot ending its probe run
+    std::size_t probe(Key key) const {
+        std::size_t mask = slots.size() - 1;
+        std::size_t i = home(key);
+        while (slots[i].key != kEmpty && slots[i].key != key) i = (i + 1) & mask;
+        return i;
+    }
+
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2, Slot{kEmpty, Value{}});
+        old.swap(slots);
+        for (const Slot& slot : old) {
+            if (slot.key != kEmpty) slots[probe(slot.key)] = slot;
+        }
+    }
+
+    std::vector<Slot> slots;
+    std::size_t count = 0;
+};
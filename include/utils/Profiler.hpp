@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Per-phase step profiling. Compiled in when ABMS_PROFILING is non-zero
+// (the default) and switched on at runtime with Profiler::setEnabled; a
+// disabled profiler costs one branch per scope, a compiled-out one nothing.
+// An enabled profiler times one step in kStepSampleEvery, and per-order
+// phases one call in kCallSampleEvery (see SampledTimer): a clock read
+// costs tens of nanoseconds, too much to pay on every step and order.
+#ifndef ABMS_PROFILING
+#define ABMS_PROFILING 1
+#endif
+
+enum class Phase : std::uint8_t {
+    Step,            // whole stepSimulation
+    AgentAct,        // decisions (sequential mode: including order placement)
+    LimitPlacement,  // addLimitOrder/submitOrder, per call (sampled)
+    MarketMatching,  // matchMarketOrder, per call (sampled)
+    FillDispatch,
+    PnLValuation,
+    Recording,
+    BookPrint,
+    Count
+};
+
+// Log-linear histogram of nanosecond durations: exact below 16 ns, then
+// eight buckets per power of two (about 12% resolution).
+class LatencyHistogram {
+public:
+    void add(std::uint64_t ns);
+    std::uint64_t count() const { return total; }
+    std::uint64_t max() const { return maxValue; }
+    // Lower bound of the bucket holding the q-th value
+    std::uint64_t quantile(double q) const;
+
+private:
+    static constexpr int kSubBuckets = 8;
+    static constexpr int kBuckets = 16 + (64 - 4) * kSubBuckets;
+
+    static int bucketOf(std::uint64_t ns);
+    static std::uint64_t bucketFloor(int bucket);
+
+    std::array<std::uint64_t, kBuckets> counts{};
+    std::uint64_t total = 0;
+    std::uint64_t maxValue = 0;
+};
+
+class Profiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // One step in this many is timed, starting with the first
+    static constexpr std::uint64_t kStepSampleEvery = 16;
+    // One call in this many of a sampled phase is timed
+    static constexpr std::uint64_t kCallSampleEvery = 256;
+
+    void setEnabled(bool on) {
+        enabled = on;
+        timing = on;
+        stepCount = 0;
+    }
+    bool isEnabled() const { return enabled; }
+
+    // Per-step totals: scopes of a timed step add into it, endStep() records
+    // each phase's total into its histogram and picks the next timed step
+    void add(Phase phase, std::uint64_t ns) { stepTotals[static_cast<int>(phase)] += ns; }
+    void endStep();
+
+    // One timed call of a sampled phase: recorded on its own, not into the step total
+    void addSample(Phase phase, std::uint64_t ns) {
+        histograms[static_cast<int>(phase)].add(ns);
+        perCall[static_cast<int>(phase)] = true;
+    }
+
+    // Run-level totals reported alongside the phases (e.g. book activity)
+    void setCounter(const std::string& name, std::uint64_t value);
+
+    const LatencyHistogram& histogram(Phase phase) const { return histograms[static_cast<int>(phase)]; }
+    std::uint64_t callCount(Phase phase) const { return calls[static_cast<int>(phase)]; }
+
+    void printSummary(std::ostream& out) const;
+    void writeJson(std::ostream& out) const;
+
+    // Profiler that scoped timers on this thread report to (may be null)
+    static Profiler* active() { return current; }
+
+    // Makes a profiler active on the current thread for its lifetime
+    class Activation {
+    public:
+        explicit Activation(Profiler& profiler);
+        ~Activation();
+        Activation(const Activation&) = delete;
+        Activation& operator=(const Activation&) = delete;
+    private:
+        Profiler* previous;
+    };
+
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Phase phase)
+            : profiler(active()), phase(phase) {
+            if (profiler && profiler->enabled) {
+                ++profiler->calls[static_cast<int>(phase)];
+                if (profiler->timing) {
+                    start = Clock::now();
+                    return;
+                }
+            }
+            profiler = nullptr;
+        }
+        ~ScopedTimer() {
+            if (profiler) {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+                profiler->add(phase, static_cast<std::uint64_t>(ns));
+            }
+        }
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    private:
+        Profiler* profiler;
+        Phase phase;
+        Clock::time_point start;
+    };
+
+    // Scoped timer for phases entered once per order: counts every call but
+    // reads the clock for one in kCallSampleEvery, whose duration goes into the
+    // phase's histogram as a per-call latency
+    class SampledTimer {
+    public:
+        explicit SampledTimer(Phase phase)
+            : profiler(active()), phase(phase) {
+            if (profiler && profiler->enabled
+                && profiler->calls[static_cast<int>(phase)]++ % kCallSampleEvery == 0) {
+                start = Clock::now();
+            } else {
+                profiler = nullptr;
+            }
+        }
+        ~SampledTimer() {
+            if (profiler) {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+                profiler->addSample(phase, static_cast<std::uint64_t>(ns));
+            }
+        }
+        SampledTimer(const SampledTimer&) = delete;
+        SampledTimer& operator=(const SampledTimer&) = delete;
+    private:
+        Profiler* profiler;
+        Phase phase;
+        Clock::time_point start;
+    };
+
+    static const char* phaseName(Phase phase);
+
+private:
+    static constexpr int kPhases = static_cast<int>(Phase::Count);
+
+    // Defined inline so that scopes read it without a call
+    static inline thread_local Profiler* current = nullptr;
+
+    bool enabled = false;
+    bool timing = false;  // the current step is timed
+    std::uint64_t stepCount = 0;
+    std::array<std::uint64_t, kPhases> stepTotals{};
+    std::array<std::uint64_t, kPhases> calls{};
+    std::array<LatencyHistogram, kPhases> histograms{};
+    std::array<bool, kPhases> perCall{};  // histogram holds sampled calls, not steps
+    std::vector<std::pair<std::string, std::uint64_t>> counters;
+};
+
+#define ABMS_PROFILE_CONCAT_INNER(a, b) a##b
+#define ABMS_PROFILE_CONCAT(a, b) ABMS_PROFILE_CONCAT_INNER(a, b)
+
+#if ABMS_PROFILING
+#define ABMS_PROFILE_SCOPE(phase) \
+    Profiler::ScopedTimer ABMS_PROFILE_CONCAT(abmsProfileScope, __LINE__)(phase)
+#define ABMS_PROFILE_SAMPLED(phase) \
+    Profiler::SampledTimer ABMS_PROFILE_CONCAT(abmsProfileScope, __LINE__)(phase)
+// Counter updates that vanish when profiling is compiled out
+#define ABMS_COUNT(expr) (expr)
+#else
+#define ABMS_PROFILE_SCOPE(phase) ((void)0)
+#define ABMS_PROFILE_SAMPLED(phase) ((void)0)
+#define ABMS_COUNT(expr) ((void)0)
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+// SplitMix64: tiny, well-mixed generator used to derive independent seeds
+// and shuffle orders from a single master seed.
+inline std::uint64_t splitmix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Seed for sub-stream `stream` (replica, agent, ...) of `master`
+inline std::uint64_t deriveSeed(std::uint64_t master, std::uint64_t stream) {
+    std::uint64_t state = master ^ (stream * 0xD1B54A32D192ED03ULL);
+    return splitmix64(state);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Capacity is rounded up to a power of two. Head and tail sit on
+// their own cache lines, and each side keeps a cached copy of the other's
+// index, so most pushes and pops never read the other side's line.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity)
+        : mask(roundUp(capacity) - 1),
+          slots(std::make_unique<T[]>(mask + 1)) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side; false if the ring is full
+    bool tryPush(const T& value) {
+        std::size_t tail = producer.index.load(std::memory_order_relaxed);
+        if (tail - producer.cached > mask) {
+            producer.cached = consumer.index.load(std::memory_order_acquire);
+            if (tail - producer.cached > mask) return false;
+        }
+        slots[tail & mask] = value;
+        producer.index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; false if the ring is empty
+    bool tryPop(T& out) {
+        std::size_t head = consumer.index.load(std::memory_order_relaxed);
+        if (head == consumer.cached) {
+            consumer.cached = producer.index.load(std::memory_order_acquire);
+            if (head == consumer.cached) return false;
+        }
+        out = slots[head & mask];
+        consumer.index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+
+private:
+    static constexpr std::size_t kLine = 64;
+
+    struct alignas(kLine) Side {
+        std::atomic<std::size_t> index{0};
+        std::size_t cached = 0;  // last seen index of the other side
+    };
+
+    static std::size_t roundUp(std::size_t n) {
+        std::size_t size = 2;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+    const std::size_t mask;
+    std::unique_ptr<T[]> slots;
+    Side producer;  // tail: next slot to write
+    Side consumer;  // head: next slot to read
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include "utils/StateRecorder.hpp"
+
+// Sequential chunk reader for files written by StateRecorder.
+class StateRecordReader {
+public:
+    explicit StateRecordReader(const std::string& filename);
+    ~StateRecordReader();
+
+    StateRecordReader(const StateRecordReader&) = delete;
+    StateRecordReader& operator=(const StateRecordReader&) = delete;
+
+    // Loads the next chunk into `chunk`; false at end of file
+    bool next(staterec::Chunk& chunk);
+
+private:
+    std::FILE* in;
+};
+
+// Rewrites a binary recording in the original CsvLogger format
+void convertRecordingToCsv(const std::string& inputFile, const std::string& outputFile);
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "agents/Agent.hpp"
+
+// On-disk layout shared by StateRecorder and StateRecordReader. Native byte
+// order; a file is a header followed by chunks, each chunk a row count and
+// then one contiguous array per column.
+namespace staterec {
+
+inline constexpr char kMagic[8] = {'A', 'B', 'M', 'S', 'R', 'E', 'C', '\0'};
+inline constexpr std::uint32_t kVersion = 1;
+inline constexpr std::uint32_t kColumnCount = 6;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t columnCount;
+};
+
+struct ChunkHeader {
+    std::uint32_t rows;
+    std::uint32_t reserved;
+};
+
+// One block of rows in column order: timestamp, agent_id, cash, inventory,
+// realized, unrealized.
+struct Chunk {
+    std::vector<std::int64_t> timestamp;
+    std::vector<std::int32_t> agentId;
+    std::vector<double> cash;
+    std::vector<std::int32_t> inventory;
+    std::vector<double> realized;
+    std::vector<double> unrealized;
+
+    std::size_t size() const { return timestamp.size(); }
+    void reserve(std::size_t rows);
+    void clear();
+};
+
+} // namespace staterec
+
+// Binary, columnar replacement for the CSV state log. The simulation thread
+// only copies agent state into a preallocated chunk; full chunks are handed
+// to a background thread that appends them to the file, so two chunks are
+// enough to keep both sides busy.
+class StateRecorder {
+public:
+    // Throws std::runtime_error if the file cannot be created
+    StateRecorder(const std::string& filename, std::size_t chunkRows = 1 << 16);
+    ~StateRecorder();
+
+    StateRecorder(const StateRecorder&) = delete;
+    StateRecorder& operator=(const StateRecorder&) = delete;
+
+    void log(int timestamp, const std::vector<std::shared_ptr<Agent>>& agents, double marketPrice);
+    // Flushes the partial chunk and waits for the writer to finish. Throws
+    // std::runtime_error if any write failed (disk full, I/O error); the
+    // destructor closes without reporting.
+    void close();
+
+private:
+    void submit();
+    void writerLoop();
+    // close() without the throw; false if anything failed to reach the file
+    bool finish();
+
+    std::string filename;
+    std::FILE* out;
+    bool failed;  // set by the writer thread, read after joining it
+    std::size_t chunkRows;
+    staterec::Chunk buffers[2];
+    staterec::Chunk* active;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    staterec::Chunk* pending;   // handed to the writer, not yet picked up
+    staterec::Chunk* spare;     // written and free for reuse
+    bool stopping;
+    std::thread writer;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Streaming mean/variance/min/max (Welford), mergeable across threads.
+class RunningStats {
+public:
+    void add(double value);
+    void merge(const RunningStats& other);
+
+    std::uint64_t count() const { return n; }
+    double mean() const { return meanValue; }
+    double variance() const { return n > 1 ? m2 / static_cast<double>(n - 1) : 0.0; }
+    double stddev() const;
+    double min() const { return minValue; }
+    double max() const { return maxValue; }
+
+private:
+    std::uint64_t n = 0;
+    double meanValue = 0.0;
+    double m2 = 0.0;
+    double minValue = 0.0;
+    double maxValue = 0.0;
+};
+
+// Fixed-range histogram for approximate quantiles without keeping samples.
+// Values outside [low, high) are counted in the edge bins.
+class Histogram {
+public:
+    Histogram(double low = -1.0, double high = 1.0, std::size_t bins = 100);
+
+    void add(double value);
+    void merge(const Histogram& other);
+    // Linear interpolation inside the bin holding the q-th sample
+    double quantile(double q) const;
+
+private:
+    double low;
+    double high;
+    std::vector<std::uint64_t> counts;
+    std::uint64_t total = 0;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size fork/join pool. parallelFor splits [0, count) into one
+// contiguous chunk per thread; chunk boundaries depend only on count and
+// the thread count, so per-chunk outputs can be merged deterministically.
+class ThreadPool {
+public:
+    using ChunkFn = std::function<void(std::size_t begin, std::size_t end, std::size_t chunk)>;
+
+    // `threads` includes the calling thread, which runs chunk 0
+    explicit ThreadPool(std::size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const { return workers.size() + 1; }
+
+    // Blocks until every chunk has run; rethrows the first exception
+    void parallelFor(std::size_t count, const ChunkFn& fn);
+
+private:
+    void workerLoop(std::size_t chunk);
+    void runChunk(std::size_t chunk);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable startCv;
+    std::condition_variable doneCv;
+
+    const ChunkFn* job = nullptr;
+    std::size_t jobCount = 0;
+    std::size_t generation = 0;
+    std::size_t remaining = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool for many independent, uneven tasks. Each worker owns a deque: it
+// pops its own work LIFO and, when empty, steals FIFO from the others, so
+// long tasks on one worker do not leave the rest idle.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(std::size_t threads);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    std::size_t size() const { return queues.size(); }
+
+    // Tasks are spread round-robin; workers rebalance by stealing
+    void submit(Task task);
+    // Blocks until every submitted task has run; rethrows the first exception
+    void wait();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(std::size_t self);
+    bool tryPop(std::size_t self, Task& task);
+    bool trySteal(std::size_t self, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> nextQueue{0};
+
+    std::mutex mutex;
+    std::condition_variable workCv;
+    std::condition_variable doneCv;
+    std::size_t queued = 0;    // submitted, not yet picked up
+    std::size_t pending = 0;   // submitted, not yet finished
+    bool stopping = false;
+    std::exception_ptr error;
+};
@@ -1,31 +1,302 @@
 #include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <random>
+#include <string>
+#include <string_view>
 #include "core/MarketSimulator.hpp"
+#include "core/MultiMarketSimulator.hpp"
+#include "core/EnsembleRunner.hpp"
+#include "core/EventSimulator.hpp"
+#include "core/GatewaySimulator.hpp"
 #include "agents/NoiseTrader.hpp"
+#include "agents/BasketNoiseTrader.hpp"
+#include "agents/NoiseTraderPopulation.hpp"
+#include "utils/Log.hpp"
 
-int main() {
-    std::cout << "Adversarial Market Simulation Starting...\n";
+namespace {
 
-    MarketSimulator sim(50);
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--quiet] [--steps N] [--agents N] [--population N] [--threads N]"
+              << " [--seed S] [--instruments N] [--replicas N] [--record-dir DIR] [--profile] [--profile-json FILE]"
+              << " [--cost-basis fifo|average]"
+              << " [--events] [--latency N] [--wake-interval X]"
+              << " [--checkpoint FILE [--checkpoint-at N]] [--restore FILE]"
+              << " [--journal FILE]"
+              << " [--market-data FILE [--symbol S] [--handoff SECONDS]]"
+              << " [--self-trade skip|cancel-resting|cancel-aggressor|decrement-both]"
+              << " [--gateway N [--sequenced] [--matching-cpu N]]"
+              << " [--log-level error|warn|info|debug|trace]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    SimulatorConfig config;
+    bool quiet = false;
+    bool seeded = false;
+    int agentCount = 15;
+    std::size_t populationSize = 0;
+    CostBasisMethod costBasis = CostBasisMethod::FIFO;
+    bool eventDriven = false;
+    SimTime latency = 0;
+    double wakeInterval = 1.0;
+    std::string checkpointPath;
+    int checkpointAt = -1;
+    std::string restorePath;
+    std::string marketDataPath;
+    std::string symbol;
+    double handoffSeconds = 1e30;
+    std::size_t instruments = 1;
+    std::size_t replicas = 0;
+    std::string recordDir;
+    unsigned gatewayShards = 0;
+    bool sequenced = false;
+    int matchingCpu = -1;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--quiet" || arg == "-q") {
+            quiet = true;
+        } else if (arg == "--steps" && i + 1 < argc) {
+            config.steps = std::stoi(argv[++i]);
+        } else if (arg == "--agents" && i + 1 < argc) {
+            agentCount = std::stoi(argv[++i]);
+        } else if (arg == "--population" && i + 1 < argc) {
+            populationSize = std::stoul(argv[++i]);
+        } else if (arg == "--instruments" && i + 1 < argc) {
+            instruments = std::stoul(argv[++i]);
+        } else if (arg == "--replicas" && i + 1 < argc) {
+            replicas = std::stoul(argv[++i]);
+        } else if (arg == "--record-dir" && i + 1 < argc) {
+            recordDir = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            config.decisionThreads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            config.seed = std::stoull(argv[++i]);
+            seeded = true;
+        } else if (arg == "--profile") {
+            config.profile = true;
+        } else if (arg == "--profile-json" && i + 1 < argc) {
+            config.profileJsonPath = argv[++i];
+        } else if (arg == "--cost-basis" && i + 1 < argc) {
+            std::string_view method = argv[++i];
+            if (method == "fifo") costBasis = CostBasisMethod::FIFO;
+            else if (method == "average") costBasis = CostBasisMethod::AverageCost;
+            else { printUsage(argv[0]); return 1; }
+        } else if (arg == "--self-trade" && i + 1 < argc) {
+            std::string_view policy = argv[++i];
+            if (policy == "skip") config.selfTradePolicy = SelfTradePolicy::Skip;
+            else if (policy == "cancel-resting") config.selfTradePolicy = SelfTradePolicy::CancelResting;
+            else if (policy == "cancel-aggressor") config.selfTradePolicy = SelfTradePolicy::CancelAggressor;
+            else if (policy == "decrement-both") config.selfTradePolicy = SelfTradePolicy::DecrementBoth;
+            else { printUsage(argv[0]); return 1; }
+        } else if (arg == "--gateway" && i + 1 < argc) {
+            gatewayShards = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--sequenced") {
+            sequenced = true;
+        } else if (arg == "--matching-cpu" && i + 1 < argc) {
+            matchingCpu = std::stoi(argv[++i]);
+        } else if (arg == "--events") {
+            eventDriven = true;
+        } else if (arg == "--latency" && i + 1 < argc) {
+            latency = std::stoull(argv[++i]);
+        } else if (arg == "--wake-interval" && i + 1 < argc) {
+            wakeInterval = std::stod(argv[++i]);
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpointPath = argv[++i];
+        } else if (arg == "--checkpoint-at" && i + 1 < argc) {
+            checkpointAt = std::stoi(argv[++i]);
+        } else if (arg == "--restore" && i + 1 < argc) {
+            restorePath = argv[++i];
+        } else if (arg == "--market-data" && i + 1 < argc) {
+            marketDataPath = argv[++i];
+        } else if (arg == "--symbol" && i + 1 < argc) {
+            symbol = argv[++i];
+        } else if (arg == "--handoff" && i + 1 < argc) {
+            handoffSeconds = std::stod(argv[++i]);
+        } else if (arg == "--journal" && i + 1 < argc) {
+            config.journalPath = argv[++i];
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            std::string_view level = argv[++i];
+            if (level == "error") logging::setLevel(LogLevel::Error);
+            else if (level == "warn") logging::setLevel(LogLevel::Warn);
+            else if (level == "info") logging::setLevel(LogLevel::Info);
+            else if (level == "debug") logging::setLevel(LogLevel::Debug);
+            else if (level == "trace") logging::setLevel(LogLevel::Trace);
+            else { printUsage(argv[0]); return 1; }
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    // Headless: only errors and the final summary
+    if (quiet) logging::setLevel(LogLevel::Error);
+
+    ABMS_LOG(LogLevel::Info, LogCategory::General, "Adversarial Market Simulation Starting...\n");
+
+    if (replicas > 0) {
+        // Monte Carlo ensemble: independent seeded replicas across all cores
+        logging::setLevel(LogLevel::Error);
+
+        EnsembleConfig ensemble;
+        ensemble.replicas = replicas;
+        ensemble.masterSeed = config.seed;
+        ensemble.threads = config.decisionThreads;
+        ensemble.simulator.steps = config.steps;
+        ensemble.simulator.selfTradePolicy = config.selfTradePolicy;
+        ensemble.recordingDir = recordDir;
+
+        EnsembleRunner runner(ensemble, [agentCount, costBasis](MarketSimulator& sim, std::uint64_t replicaSeed) {
+            for (int id = 301; id < 301 + agentCount; ++id) {
+                auto trader = std::make_shared<NoiseTrader>(id, replicaSeed);
+                trader->setCostBasisMethod(costBasis);
+                sim.addAgent(std::move(trader));
+            }
+        });
+        try {
+            runner.run().print(std::cout);
+        } catch (const std::exception& e) {
+            ABMS_LOG(LogLevel::Error, LogCategory::General, e.what() << "\n");
+            return 1;
+        }
+        return 0;
+    }
+
+    if (instruments > 1) {
+        // Basket of instruments: one book per symbol, matched in parallel
+        MultiSimulatorConfig multiConfig;
+        multiConfig.steps = config.steps;
+        multiConfig.instruments = instruments;
+        multiConfig.threads = std::max(1u, config.decisionThreads);
+        multiConfig.seed = config.seed;
+        multiConfig.selfTradePolicy = config.selfTradePolicy;
+
+        MultiMarketSimulator sim(multiConfig);
+        for (int id = 301; id < 301 + agentCount; ++id) {
+            sim.addAgent(std::make_shared<BasketNoiseTrader>(id, instruments, config.seed));
+        }
+        sim.run();
+        return 0;
+    }
+
+    if (gatewayShards > 0) {
+        // Agent shards on their own threads, matching on one thread behind ring buffers
+        GatewaySimulatorConfig gatewayConfig;
+        gatewayConfig.steps = config.steps;
+        gatewayConfig.shards = gatewayShards;
+        gatewayConfig.sequenced = sequenced;
+        gatewayConfig.matchingCpu = matchingCpu;
+        gatewayConfig.selfTradePolicy = config.selfTradePolicy;
+
+        GatewaySimulator sim(gatewayConfig);
+        for (int id = 301; id < 301 + agentCount; ++id) {
+            auto trader = seeded ? std::make_shared<NoiseTrader>(id, config.seed)
+                                 : std::make_shared<NoiseTrader>(id);
+            trader->setCostBasisMethod(costBasis);
+            sim.addAgent(std::move(trader));
+        }
+        sim.run();
+        return 0;
+    }
+
+    if (eventDriven) {
+        // Event-driven: agents wake on their own schedule, orders arrive after latency
+        EventSimulatorConfig eventConfig;
+        eventConfig.endTime = static_cast<SimTime>(config.steps);
+        eventConfig.orderLatency = latency;
+        eventConfig.recordingPath = config.recordingPath;
+        eventConfig.selfTradePolicy = config.selfTradePolicy;
+
+        EventSimulator sim(eventConfig);
+        for (int id = 301; id < 301 + agentCount; ++id) {
+            auto trader = seeded ? std::make_shared<NoiseTrader>(id, config.seed)
+                                 : std::make_shared<NoiseTrader>(id);
+            trader->setCostBasisMethod(costBasis);
+            trader->setWakeInterval(wakeInterval);
+            sim.addAgent(std::move(trader));
+        }
+        try {
+            sim.run();
+        } catch (const std::exception& e) {
+            ABMS_LOG(LogLevel::Error, LogCategory::General, e.what() << "\n");
+            return 1;
+        }
+        return 0;
+    }
+
+    MarketSimulator sim(config);
     
-    // Add agents with initial cash of 10,000 each (as defined in Agent constructor)
-    sim.addAgent(std::make_shared<NoiseTrader>(301));
-    sim.addAgent(std::make_shared<NoiseTrader>(302));
-    sim.addAgent(std::make_shared<NoiseTrader>(303));
-    sim.addAgent(std::make_shared<NoiseTrader>(304));
-    sim.addAgent(std::make_shared<NoiseTrader>(305));
-    sim.addAgent(std::make_shared<NoiseTrader>(306));
-    sim.addAgent(std::make_shared<NoiseTrader>(307));
-    sim.addAgent(std::make_shared<NoiseTrader>(308));
-    sim.addAgent(std::make_shared<NoiseTrader>(309));
-    sim.addAgent(std::make_shared<NoiseTrader>(310));
-    sim.addAgent(std::make_shared<NoiseTrader>(311));
-    sim.addAgent(std::make_shared<NoiseTrader>(312));
-    sim.addAgent(std::make_shared<NoiseTrader>(313));
-    sim.addAgent(std::make_shared<NoiseTrader>(314));
-    sim.addAgent(std::make_shared<NoiseTrader>(315));
-
-    sim.run();
+    // Add agents with initial cash of 10,000 each (as defined in Agent constructor).
+    // With --seed every trader's draws are keyed by the seed and its id.
+    for (int id = 301; id < 301 + agentCount; ++id) {
+        auto trader = seeded ? std::make_shared<NoiseTrader>(id, config.seed)
+                             : std::make_shared<NoiseTrader>(id);
+        trader->setCostBasisMethod(costBasis);
+        sim.addAgent(std::move(trader));
+    }
+
+    // Array-backed noise traders, numbered after the regular agents
+    if (populationSize > 0) {
+        std::uint64_t populationSeed = seeded ? config.seed : std::random_device{}();
+        sim.addPopulation(std::make_shared<NoiseTraderPopulation>(301 + agentCount, populationSize, populationSeed));
+    }
+
+    // Start from a historical book: load order flow up to the handoff time
+    if (!marketDataPath.empty()) {
+        try {
+            MarketDataLoader loader(marketDataPath, symbol);
+            auto handoff = handoffSeconds >= 86400.0 ? std::numeric_limits<std::uint64_t>::max()
+                                                     : static_cast<std::uint64_t>(handoffSeconds * 1e9);
+            sim.seedFromMarketData(loader, handoff);
+            const auto& stats = loader.getStats();
+            ABMS_LOG(LogLevel::Info, LogCategory::General,
+                     "Loaded " << stats.messages << " messages (" << stats.adds << " adds, "
+                     << stats.executions << " executions, " << stats.cancels + stats.deletes << " cancels, "
+                     << stats.replaces << " replaces) from " << marketDataPath << "\n");
+        } catch (const std::exception& e) {
+            ABMS_LOG(LogLevel::Error, LogCategory::General, "Cannot load " << marketDataPath << ": " << e.what() << "\n");
+            return 1;
+        }
+    }
+
+    // Continue from a saved state; --steps is still the total step count
+    if (!restorePath.empty()) {
+        try {
+            sim.loadCheckpoint(restorePath);
+        } catch (const std::exception& e) {
+            ABMS_LOG(LogLevel::Error, LogCategory::General, "Cannot restore " << restorePath << ": " << e.what() << "\n");
+            return 1;
+        }
+    }
+
+    if (!checkpointPath.empty() && checkpointAt >= 0) {
+        while (!sim.isFinished() && sim.getTimestamp() < checkpointAt) {
+            sim.stepSimulation();
+        }
+        sim.saveCheckpoint(checkpointPath);
+        ABMS_LOG(LogLevel::Info, LogCategory::General,
+                 "Checkpoint at step " << sim.getTimestamp() << " written to " << checkpointPath << "\n");
+    }
+
+    // A recording that could not be written fails the run
+    try {
+        sim.run();
+    } catch (const std::exception& e) {
+        ABMS_LOG(LogLevel::Error, LogCategory::General, e.what() << "\n");
+        return 1;
+    }
+
+    // Without --checkpoint-at the checkpoint holds the state after the last step
+    if (!checkpointPath.empty() && checkpointAt < 0) {
+        sim.saveCheckpoint(checkpointPath);
+        ABMS_LOG(LogLevel::Info, LogCategory::General,
+                 "Checkpoint at step " << sim.getTimestamp() << " written to " << checkpointPath << "\n");
+    }
 
     return 0;
 }
@@ -1,141 +1,150 @@
 #include "agents/Agent.hpp"
+#include "core/OrderBook.hpp"
+#include "core/RiskLedger.hpp"
+#include "utils/BinaryIO.hpp"
+#include "utils/Log.hpp"
 #include <algorithm>
-#include <iostream>
 #include <iomanip>
+#include <cstdlib>
 #include <numeric>
+#include <stdexcept>
 
 Agent::Agent(int id) 
     : id(id), 
-      cash(10000.0),
+      cash(toMoney(10000.0)),
       inventory(0),
-      realizedPnL(0.0),
-      reservedLongInventory(0),
-      reservedShortInventory(0),
-      reservedCash(0.0) {}
+      realizedPnL(0),
+      costBasis(0),
+      costBasisMethod(CostBasisMethod::FIFO) {}
 
 int Agent::getId() const { return id; }
-double Agent::getRealizedPnL() const { return realizedPnL; }
-double Agent::getCash() const { return cash; }
+double Agent::getRealizedPnL() const { return moneyToDouble(realizedPnL); }
+double Agent::getCash() const { return moneyToDouble(cash); }
 int Agent::getInventory() const { return inventory; }
-int Agent::getAvailableInventory() const { return inventory - reservedShortInventory; }
-double Agent::getAvailableCash() const { return cash - reservedCash; }
-
-void Agent::cancelReservation(OrderSide side, int quantity, double price) {
-    if (side == OrderSide::BUY) {
-        reservedCash -= quantity * price;
-        reservedLongInventory -= quantity;
-    } else {
-        reservedShortInventory -= quantity;
+int Agent::getAvailableInventory() const {
+    if (!ledger) return inventory;
+    return inventory - static_cast<int>(ledger->of(id).shortQty);
+}
+
+double Agent::getAvailableCash() const {
+    if (!ledger) return moneyToDouble(cash);
+    return moneyToDouble(cash - ledger->of(id).cash());
+}
+
+void Agent::setCostBasisMethod(CostBasisMethod method) {
+    if (inventory != 0) {
+        throw std::logic_error("Cost basis method can only change while flat");
     }
+    costBasisMethod = method;
 }
 
-void Agent::onFill(const Fill& fill) {
-    // Handle reservation fills
-    if (fill.isReservation) {
-        if (fill.side == OrderSide::BUY) {
-            reservedCash += fill.quantity * fill.price;
-            reservedLongInventory += fill.quantity;
-        } else {
-            reservedShortInventory += fill.quantity;
-        }
-        return;
+void Agent::saveState(BinaryWriter& out) const {
+    out.write<Money>(cash);
+    out.write<std::int32_t>(inventory);
+    out.write<Money>(realizedPnL);
+    out.write<Money>(costBasis);
+    out.write<std::uint8_t>(static_cast<std::uint8_t>(costBasisMethod));
+    out.write<std::uint64_t>(positionQueue.size());
+    for (const auto& [qty, price] : positionQueue) {
+        out.write<std::int32_t>(qty);
+        out.write<Money>(price);
+    }
+}
+
+void Agent::loadState(BinaryReader& in) {
+    cash = in.read<Money>();
+    inventory = in.read<std::int32_t>();
+    realizedPnL = in.read<Money>();
+    costBasis = in.read<Money>();
+    costBasisMethod = static_cast<CostBasisMethod>(in.read<std::uint8_t>());
+    positionQueue.clear();
+    auto lots = in.read<std::uint64_t>();
+    for (std::uint64_t i = 0; i < lots; ++i) {
+        int qty = in.read<std::int32_t>();
+        Money price = in.read<Money>();
+        positionQueue.emplace_back(qty, price);
     }
+}
+
+void Agent::decide(const MarketSnapshot&, long, std::vector<OrderIntent>&) {}
+
+void Agent::act(OrderBook& book, long timestamp) {
+    actIntents.clear();
+    decide(MarketSnapshot::of(book), timestamp, actIntents);
+    submitIntents(book, actIntents, timestamp);
+}
 
+void Agent::onFill(const Fill& fill) {
     int qty = fill.quantity;
-    double price = fill.price;
-    
-    // Determine if we're buying or selling
-    bool isBuying = (fill.side == OrderSide::SELL);
-    
+    bool isBuying = (fill.side == OrderSide::BUY);
+
     // Log the fill
-    std::cout << "Agent " << id << " " << (isBuying ? "BUY" : "SELL") 
-              << " " << qty << " @ " << std::fixed << std::setprecision(2) << price << std::endl;
-    
-    // Update inventory and cash
-    if (isBuying) {
-        // We're buying
-        cash -= qty * price;
-        inventory += qty;
-        
-        // Release reserved cash for limit orders
-        if (fill.agentId == id) {
-            reservedCash = std::max(0.0, reservedCash - (qty * price));
-            reservedLongInventory = std::max(0, reservedLongInventory - qty);
-        }
-        
-        // Handle covering short positions
-        int remainingQty = qty;
-        while (remainingQty > 0 && !positionQueue.empty() && positionQueue.front().first < 0) {
-            auto& [posQty, posPrice] = positionQueue.front();
-            int coverQty = std::min(remainingQty, -posQty);
-            
-            double pnl = (posPrice - price) * coverQty;
-            realizedPnL += pnl;
-            
-            std::cout << "  Covered " << coverQty << " shorts @ " << posPrice 
-                      << ", bought @ " << price << ", PnL: " << pnl << std::endl;
-            
-            posQty += coverQty;
-            remainingQty -= coverQty;
-            
-            if (posQty == 0) {
-                positionQueue.pop_front();
+    ABMS_LOG(LogLevel::Debug, LogCategory::Fill,
+             "Agent " << id << " " << (isBuying ? "BUY" : "SELL")
+             << " " << qty << " @ " << std::fixed << std::setprecision(2) << moneyToDouble(priceOf(fill)) << "\n");
+
+    // Reservations were already released by the book
+    Money price = priceOf(fill);
+    Money notional = price * qty;
+    cash += isBuying ? -notional : notional;
+
+    Money realizedBefore = realizedPnL;
+    applyTrade(isBuying ? qty : -qty, price);
+    ABMS_LOG(LogLevel::Trace, LogCategory::Fill,
+             "  Realized " << moneyToDouble(realizedPnL - realizedBefore) << ", position " << inventory
+             << " (" << positionQueue.size() << " lots)\n");
+}
+
+void Agent::applyTrade(int signedQty, Money price) {
+
+    // Closing part: the trade runs against the open position
+    if (inventory != 0 && (inventory > 0) != (signedQty > 0)) {
+        int closing = std::min(std::abs(signedQty), std::abs(inventory));
+        int closedSigned = (inventory > 0) ? closing : -closing;
+
+        if (costBasisMethod == CostBasisMethod::FIFO) {
+            int remaining = closing;
+            while (remaining > 0) {
+                auto& [lotQty, lotPrice] = positionQueue.front();
+                int take = std::min(remaining, std::abs(lotQty));
+                int takenSigned = (lotQty > 0) ? take : -take;
+                realizedPnL += (price - lotPrice) * takenSigned;
+                costBasis -= lotPrice * takenSigned;
+                lotQty -= takenSigned;
+                remaining -= take;
+                if (lotQty == 0) positionQueue.pop_front();
             }
+        } else {
+            Money closedCost = averageCost(costBasis, inventory, closedSigned);
+            realizedPnL += price * closedSigned - closedCost;
+            costBasis -= closedCost;
         }
-        
-        // Add remaining as new long position
-        if (remainingQty > 0) {
-            positionQueue.push_back({remainingQty, price});
-            std::cout << "  New long position: " << remainingQty << " @ " << price << std::endl;
-        }
-    } else {
-        // We're selling
-        cash += qty * price;
-        inventory -= qty;
-        
-        // Release reserved inventory for limit orders
-        if (fill.agentId == id) {
-            reservedShortInventory = std::max(0, reservedShortInventory - qty);
-        }
-        
-        // Handle selling long positions
-        int remainingQty = qty;
-        while (remainingQty > 0 && !positionQueue.empty() && positionQueue.front().first > 0) {
-            auto& [posQty, posPrice] = positionQueue.front();
-            int sellQty = std::min(remainingQty, posQty);
-            
-            double pnl = (price - posPrice) * sellQty;
-            realizedPnL += pnl;
-            
-            std::cout << "  Sold " << sellQty << " longs @ " << posPrice 
-                      << ", sold @ " << price << ", PnL: " << pnl << std::endl;
-            
-            posQty -= sellQty;
-            remainingQty -= sellQty;
-            
-            if (posQty == 0) {
-                positionQueue.pop_front();
+
+        inventory -= closedSigned;
+        signedQty += closedSigned;
+    }
+
+    // Opening part: whatever is left adds to (or starts) the position
+    if (signedQty != 0) {
+        inventory += signedQty;
+        costBasis += price * signedQty;
+        if (costBasisMethod == CostBasisMethod::FIFO) {
+            if (!positionQueue.empty() && positionQueue.back().second == price) {
+                positionQueue.back().first += signedQty;
+            } else {
+                positionQueue.emplace_back(signedQty, price);
             }
         }
-        
-        // Add remaining as new short position
-        if (remainingQty > 0) {
-            positionQueue.push_back({-remainingQty, price});
-            std::cout << "  New short position: " << -remainingQty << " @ " << price << std::endl;
-        }
+    }
+}
+
+void Agent::onFill(std::span<const Fill> fills) {
+    for (const auto& fill : fills) {
+        onFill(fill);
     }
 }
 
 double Agent::getUnrealizedPnL(double marketPrice) const {
     if (inventory == 0) return 0.0;
-    
-    double unrealizedPnL = 0.0;
-    for (const auto& [qty, entryPrice] : positionQueue) {
-        if (qty > 0) {
-            unrealizedPnL += (marketPrice - entryPrice) * qty;
-        } else if (qty < 0) {
-            unrealizedPnL += (entryPrice - marketPrice) * (-qty);
-        }
-    }
-    return unrealizedPnL;
+    return marketPrice * inventory - moneyToDouble(costBasis);
 }
@@ -0,0 +1,47 @@
+#include "agents/BasketNoiseTrader.hpp"
+#include <algorithm>
+
+BasketNoiseTrader::BasketNoiseTrader(int id, std::size_t instruments, std::uint64_t seed)
+    : MultiAssetAgent(id, instruments),
+      rng(seed, static_cast<std::uint64_t>(id)) {}
+
+void BasketNoiseTrader::decide(std::span<const MarketSnapshot> markets, long timestamp,
+                               std::vector<InstrumentIntent>& out) {
+    if (markets.empty()) return;
+
+    CounterRng draws = rng.at(static_cast<std::uint64_t>(timestamp));
+    auto instrument = static_cast<std::uint32_t>(draws.uniformInt(0, static_cast<int>(markets.size()) - 1));
+    const MarketSnapshot& market = markets[instrument];
+    OrderSide side = (draws.uniformInt(0, 1) == 0) ? OrderSide::BUY : OrderSide::SELL;
+    int qty = draws.uniformInt(1, 10);
+
+    if (draws.uniformInt(0, 1) == 0) {
+        // Limit order around the mid, same price rule as NoiseTrader
+        double mid = market.midPrice;
+        double price = (side == OrderSide::BUY) ?
+            mid * 0.995 + draws.uniform(99.0, 101.0) * 0.01 :
+            mid * 1.005 - draws.uniform(99.0, 101.0) * 0.01;
+        price = std::clamp(price, 95.0, 105.0);
+
+        if (side == OrderSide::BUY) {
+            qty = std::min(qty, static_cast<int>(getAvailableCash() / price));
+            if (qty < 1) return;
+            commitCash(qty * price);
+        } else {
+            // Short selling limited by the same cash as buys
+            qty = std::min(qty, static_cast<int>(getAvailableCash() / price)
+                                    + std::max(0, getAvailableInventory(instrument)));
+            if (qty < 1) return;
+        }
+        out.push_back(InstrumentIntent{instrument, OrderIntent{IntentType::LIMIT, id, side, price, qty}});
+        return;
+    }
+
+    // Market order against whichever side has liquidity
+    auto opposite = (side == OrderSide::BUY) ? market.bestAsk : market.bestBid;
+    if (!opposite) return;
+    qty = std::min(qty, static_cast<int>(getAvailableCash() / *opposite));
+    if (qty < 1) return;
+    if (side == OrderSide::BUY) commitCash(qty * *opposite);
+    out.push_back(InstrumentIntent{instrument, OrderIntent{IntentType::MARKET, id, side, 0.0, qty}});
+}
@@ -0,0 +1,66 @@
+#include "agents/MultiAssetAgent.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+MultiAssetAgent::MultiAssetAgent(int id, std::size_t instruments)
+    : id(id),
+      cash(toMoney(10000.0)),
+      committedCash(0),
+      positions(instruments) {}
+
+void MultiAssetAgent::onFill(std::size_t instrument, const Fill& fill) {
+    bool buying = (fill.side == OrderSide::BUY);
+    applyTrade(positions[instrument], buying ? fill.quantity : -fill.quantity, priceOf(fill));
+}
+
+double MultiAssetAgent::getAvailableCash() const {
+    Money available = cash - committedCash;
+    for (const RiskLedger* ledger : ledgers) available -= ledger->of(id).cash();
+    return moneyToDouble(available);
+}
+
+int MultiAssetAgent::getAvailableInventory(std::size_t instrument) const {
+    int inventory = positions[instrument].inventory;
+    if (instrument >= ledgers.size()) return inventory;
+    return inventory - static_cast<int>(ledgers[instrument]->of(id).shortQty);
+}
+
+void MultiAssetAgent::applyTrade(InstrumentPosition& position, int signedQty, Money price) {
+    cash -= signedQty * price;
+
+    int remaining = std::abs(signedQty);
+    int direction = (signedQty > 0) ? 1 : -1;
+
+    // Close against the open position at its average cost
+    if (position.inventory != 0 && (position.inventory > 0) != (signedQty > 0)) {
+        int held = std::abs(position.inventory);
+        int closeQty = std::min(remaining, held);
+        int heldDirection = -direction;
+        Money closedCost = averageCost(position.costBasis, position.inventory, heldDirection * closeQty);
+
+        position.realizedPnL += heldDirection * closeQty * price - closedCost;
+        position.inventory -= heldDirection * closeQty;
+        position.costBasis -= closedCost;
+        remaining -= closeQty;
+    }
+
+    // Anything left opens (or extends) a position in the trade's direction
+    if (remaining > 0) {
+        position.inventory += direction * remaining;
+        position.costBasis += direction * remaining * price;
+    }
+}
+
+double MultiAssetAgent::getRealizedPnL() const {
+    Money total = 0;
+    for (const auto& position : positions) total += position.realizedPnL;
+    return moneyToDouble(total);
+}
+
+double MultiAssetAgent::getUnrealizedPnL(std::span<const double> marketPrices) const {
+    double total = 0.0;
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        total += positions[i].getUnrealizedPnL(marketPrices[i]);
+    }
+    return total;
+}
@@ -1,48 +1,72 @@
 #include "agents/NoiseTrader.hpp"
-#include <iostream>
+#include "utils/BinaryIO.hpp"
+#include "utils/Log.hpp"
+#include <cmath>
 #include <iomanip>
+#include <random>
 #include <stdexcept>
 
 NoiseTrader::NoiseTrader(int id)
-    : Agent(id), rng(std::random_device{}()),
-      priceDist(99.0, 101.0),
-      sideDist(0, 1),
-      qtyDist(1, 10),
-      typeDist(0, 1) {}
+    : NoiseTrader(id, std::random_device{}()) {}
 
-void NoiseTrader::act(OrderBook& book, long timestamp) {
+NoiseTrader::NoiseTrader(int id, std::uint64_t seed)
+    : Agent(id), rng(seed, static_cast<std::uint64_t>(id)) {}
+
+void NoiseTrader::decide(const MarketSnapshot& market, long timestamp, std::vector<OrderIntent>& out) {
     try {
+        CounterRng draws = rng.at(static_cast<std::uint64_t>(timestamp));
+
         // Try to place a limit order first
-        if (typeDist(rng) == 0) {
-            if (tryLimitOrder(book, timestamp)) {
+        if (draws.uniformInt(0, 1) == 0) {
+            if (tryLimitOrder(draws, market, out)) {
                 return;
             }
         }
         
         // If limit order doesn't work or we chose market order, try that
-        if (tryMarketOrder(book, timestamp)) {
+        if (tryMarketOrder(draws, market, out)) {
             return;
         }
         
         // If both strategies fail, do nothing this turn
-        std::cout << "[NoiseTrader " << id << "] No valid action available\n";
+        ABMS_LOG(LogLevel::Debug, LogCategory::Agent, "[NoiseTrader " << id << "] No valid action available\n");
         
     } catch (const std::exception& e) {
-        std::cerr << "[NoiseTrader " << id << "] Error: " << e.what() << std::endl;
+        ABMS_LOG(LogLevel::Error, LogCategory::Agent, "[NoiseTrader " << id << "] Error: " << e.what() << "\n");
     } catch (...) {
-        std::cerr << "[NoiseTrader " << id << "] Unknown error" << std::endl;
+        ABMS_LOG(LogLevel::Error, LogCategory::Agent, "[NoiseTrader " << id << "] Unknown error\n");
     }
 }
 
-bool NoiseTrader::tryLimitOrder(OrderBook& book, long timestamp) {
-    OrderSide side = (sideDist(rng) == 0) ? OrderSide::BUY : OrderSide::SELL;
-    int qty = std::max(1, std::min(qtyDist(rng), 10));
+void NoiseTrader::saveState(BinaryWriter& out) const {
+    Agent::saveState(out);
+    out.write(rng.getKey());
+    out.write(wakeInterval);
+}
+
+void NoiseTrader::loadState(BinaryReader& in) {
+    Agent::loadState(in);
+    rng = AgentRng(in.read<philox::Key>());
+    wakeInterval = in.read<double>();
+}
+
+long NoiseTrader::nextWakeup(long now) {
+    if (wakeInterval <= 1.0) return now + 1;
+    // Own sub-stream so the gap does not shift this step's decision draws
+    CounterRng draws = rng.at(static_cast<std::uint64_t>(now), 1);
+    double gap = -wakeInterval * std::log(1.0 - draws.uniform());
+    return now + std::max(1L, std::lround(gap));
+}
+
+bool NoiseTrader::tryLimitOrder(CounterRng& rng, const MarketSnapshot& market, std::vector<OrderIntent>& out) {
+    OrderSide side = (rng.uniformInt(0, 1) == 0) ? OrderSide::BUY : OrderSide::SELL;
+    int qty = std::max(1, std::min(rng.uniformInt(1, 10), 10));
     
     // Get price - slightly offset from midpoint for better execution chance
-    double midPrice = book.getMidPrice();
+    double midPrice = market.midPrice;
     double price = (side == OrderSide::BUY) ? 
-        midPrice * 0.995 + priceDist(rng) * 0.01 : 
-        midPrice * 1.005 - priceDist(rng) * 0.01;
+        midPrice * 0.995 + rng.uniform(99.0, 101.0) * 0.01 : 
+        midPrice * 1.005 - rng.uniform(99.0, 101.0) * 0.01;
     
     // Ensure price is reasonable
     price = std::max(95.0, std::min(price, 105.0));
@@ -62,23 +86,23 @@ bool NoiseTrader::tryLimitOrder(OrderBook& book, long timestamp) {
     }
     
     // Place order
-    Order order{-1, id, price, qty, side, timestamp};
-    book.addLimitOrder(order);
-    std::cout << "[NoiseTrader " << id << "] Placed LIMIT " 
-              << (side == OrderSide::BUY ? "BUY" : "SELL")
-              << " " << qty << " @ " << std::fixed << std::setprecision(2) << price << "\n";
+    out.push_back(OrderIntent{IntentType::LIMIT, id, side, price, qty});
+    ABMS_LOG(LogLevel::Debug, LogCategory::Agent,
+             "[NoiseTrader " << id << "] Placed LIMIT "
+             << (side == OrderSide::BUY ? "BUY" : "SELL")
+             << " " << qty << " @ " << std::fixed << std::setprecision(2) << price << "\n");
     return true;
 }
 
-bool NoiseTrader::tryMarketOrder(OrderBook& book, long timestamp) {
+bool NoiseTrader::tryMarketOrder(CounterRng& rng, const MarketSnapshot& market, std::vector<OrderIntent>& out) {
     // Try the side with available liquidity first
-    bool buyLiquidity = book.bestAsk().has_value();
-    bool sellLiquidity = book.bestBid().has_value();
+    bool buyLiquidity = market.bestAsk.has_value();
+    bool sellLiquidity = market.bestBid.has_value();
     
     OrderSide side;
     if (buyLiquidity && sellLiquidity) {
         // Both sides available - use random
-        side = (sideDist(rng) == 0) ? OrderSide::BUY : OrderSide::SELL;
+        side = (rng.uniformInt(0, 1) == 0) ? OrderSide::BUY : OrderSide::SELL;
     } else if (buyLiquidity) {
         side = OrderSide::BUY;
     } else if (sellLiquidity) {
@@ -88,36 +112,25 @@ bool NoiseTrader::tryMarketOrder(OrderBook& book, long timestamp) {
     }
     
     // Adjust quantity based on available resources
-    int maxQty = std::min(qtyDist(rng), 10);
+    int maxQty = std::min(rng.uniformInt(1, 10), 10);
     int qty;
     if (side == OrderSide::BUY) {
         double availableCash = getAvailableCash();
-        double estimatedPrice = book.bestAsk().value_or(100.0);
+        double estimatedPrice = market.bestAsk.value_or(100.0);
         qty = std::max(1, std::min(maxQty, static_cast<int>(availableCash / estimatedPrice)));
     } else {
         // Allow short selling with similar size constraints as buys
-        double estimatedPrice = book.bestBid().value_or(100.0);
+        double estimatedPrice = market.bestBid.value_or(100.0);
         int maxShort = static_cast<int>(getAvailableCash() / estimatedPrice);
         qty = std::min(maxQty, maxShort);
     }
     
     if (qty < 1) return false;
     
-    Order order{-1, id, 0.0, qty, side, timestamp};
-    auto fills = book.matchMarketOrder(order);
-    
-    std::cout << "[NoiseTrader " << id << "] Placed MARKET " 
-              << (side == OrderSide::BUY ? "BUY" : "SELL")
-              << " " << qty << "\n";
-              
-    if (!fills.empty()) {
-        for (const auto& fill : fills) {
-            std::cout << "  -> Filled " << fill.quantity 
-                      << " @ " << std::fixed << std::setprecision(2) << fill.price << "\n";
-        }
-        return true;
-    }
-    
-    std::cout << "  -> No fills: insufficient liquidity\n";
-    return false;
-}
\ No newline at end of file
+    out.push_back(OrderIntent{IntentType::MARKET, id, side, 0.0, qty});
+    ABMS_LOG(LogLevel::Debug, LogCategory::Agent,
+             "[NoiseTrader " << id << "] Placed MARKET "
+             << (side == OrderSide::BUY ? "BUY" : "SELL")
+             << " " << qty << "\n");
+    return true;
+}
@@ -0,0 +1,172 @@
+#include "agents/NoiseTraderPopulation.hpp"
+#include "utils/BinaryIO.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Layout of a member's choice bits (draw words 0 and 1) for one step
+constexpr std::uint64_t kTypeBit = 1u << 0;        // 0: try a limit order first
+constexpr std::uint64_t kLimitSideBit = 1u << 1;   // 0: BUY
+constexpr std::uint64_t kMarketSideBit = 1u << 2;  // 0: BUY
+constexpr int kLimitQtyShift = 16;
+constexpr int kMarketQtyShift = 32;
+
+// Uniform integer in [1, 10] from 16 random bits (multiply-shift)
+int quantityFrom(std::uint64_t bits, int shift) {
+    return 1 + static_cast<int>((((bits >> shift) & 0xFFFF) * 10) >> 16);
+}
+
+std::uint64_t choiceBits(const philox::Block& words) {
+    return (static_cast<std::uint64_t>(words[1]) << 32) | words[0];
+}
+
+double priceDraw(const philox::Block& words) {
+    return 99.0 + 2.0 * philox::toUnit(words[2], words[3]);
+}
+
+} // namespace
+
+NoiseTraderPopulation::NoiseTraderPopulation(int firstId, std::size_t count, std::uint64_t seed, double startCash)
+    : baseId(firstId),
+      cash(count, toMoney(startCash)),
+      inventory(count, 0),
+      realizedPnL(count, 0),
+      costBasis(count, 0),
+      keys(count),
+      draws(count),
+      intents(count, OrderIntent{IntentType::LIMIT, -1, OrderSide::BUY, 0.0, 0}) {
+    for (std::size_t i = 0; i < count; ++i) {
+        keys[i] = philox::deriveKey(seed, static_cast<std::uint64_t>(firstId) + i);
+    }
+}
+
+void NoiseTraderPopulation::drawBatch(std::size_t begin, std::size_t end, long timestamp) {
+    philox::generateBlocks(std::span<const philox::Key>(keys).subspan(begin, end - begin),
+                           static_cast<std::uint64_t>(timestamp), 0, 0,
+                           std::span<philox::Block>(draws).subspan(begin, end - begin));
+}
+
+bool NoiseTraderPopulation::decide(std::size_t index, const MarketSnapshot& market, OrderIntent& out) const {
+    // Same order as NoiseTrader::decide: limit first on a coin flip, market otherwise
+    if ((choiceBits(draws[index]) & kTypeBit) == 0 && tryLimitOrder(index, market, out)) {
+        return true;
+    }
+    return tryMarketOrder(index, market, out);
+}
+
+void NoiseTraderPopulation::decideRange(std::size_t begin, std::size_t end, long timestamp,
+                                        const MarketSnapshot& market) {
+    drawBatch(begin, end, timestamp);
+    for (std::size_t i = begin; i < end; ++i) {
+        if (!decide(i, market, intents[i])) intents[i].quantity = 0;
+    }
+}
+
+bool NoiseTraderPopulation::tryLimitOrder(std::size_t index, const MarketSnapshot& market, OrderIntent& out) const {
+    std::uint64_t bits = choiceBits(draws[index]);
+    OrderSide side = (bits & kLimitSideBit) == 0 ? OrderSide::BUY : OrderSide::SELL;
+    int qty = quantityFrom(bits, kLimitQtyShift);
+
+    double midPrice = market.midPrice;
+    double price = (side == OrderSide::BUY)
+        ? midPrice * 0.995 + priceDraw(draws[index]) * 0.01
+        : midPrice * 1.005 - priceDraw(draws[index]) * 0.01;
+    price = std::max(95.0, std::min(price, 105.0));
+
+    double availableCash = getAvailableCash(index);
+    if (side == OrderSide::BUY) {
+        if (availableCash < qty * price) {
+            qty = std::max(1, static_cast<int>(availableCash / price));
+        }
+    } else {
+        qty = std::min(qty, static_cast<int>(availableCash / price));
+        if (qty < 1) return false;
+    }
+
+    out = OrderIntent{IntentType::LIMIT, baseId + static_cast<int>(index), side, price, qty};
+    return true;
+}
+
+bool NoiseTraderPopulation::tryMarketOrder(std::size_t index, const MarketSnapshot& market, OrderIntent& out) const {
+    bool buyLiquidity = market.bestAsk.has_value();
+    bool sellLiquidity = market.bestBid.has_value();
+
+    OrderSide side;
+    if (buyLiquidity && sellLiquidity) {
+        side = (choiceBits(draws[index]) & kMarketSideBit) == 0 ? OrderSide::BUY : OrderSide::SELL;
+    } else if (buyLiquidity) {
+        side = OrderSide::BUY;
+    } else if (sellLiquidity) {
+        side = OrderSide::SELL;
+    } else {
+        return false;
+    }
+
+    int maxQty = quantityFrom(choiceBits(draws[index]), kMarketQtyShift);
+    double availableCash = getAvailableCash(index);
+    int qty;
+    if (side == OrderSide::BUY) {
+        double estimatedPrice = market.bestAsk.value_or(100.0);
+        qty = std::max(1, std::min(maxQty, static_cast<int>(availableCash / estimatedPrice)));
+    } else {
+        double estimatedPrice = market.bestBid.value_or(100.0);
+        qty = std::min(maxQty, static_cast<int>(availableCash / estimatedPrice));
+    }
+    if (qty < 1) return false;
+
+    out = OrderIntent{IntentType::MARKET, baseId + static_cast<int>(index), side, 0.0, qty};
+    return true;
+}
+
+void NoiseTraderPopulation::onFill(const Fill& fill) {
+    std::size_t i = indexOf(fill.agentId);
+
+    // Same side convention as Agent::onFill
+    bool isBuying = (fill.side == OrderSide::BUY);
+    int qty = fill.quantity;
+    Money price = priceOf(fill);
+    int position = inventory[i];
+
+    cash[i] += isBuying ? -qty * price : qty * price;
+
+    // Average-cost position: the part that reduces the open position
+    // realizes against its average entry, the rest opens at `price`
+    int signedQty = isBuying ? qty : -qty;
+    if (position != 0 && (position > 0) != (signedQty > 0)) {
+        int closing = std::min(qty, std::abs(position));
+        int closedSigned = position > 0 ? closing : -closing;
+        Money closedCost = averageCost(costBasis[i], position, closedSigned);
+        realizedPnL[i] += price * closedSigned - closedCost;
+        costBasis[i] -= closedCost;
+        position -= closedSigned;
+        signedQty += closedSigned;
+    }
+    costBasis[i] += price * signedQty;
+    inventory[i] = position + signedQty;
+}
+
+void NoiseTraderPopulation::saveState(BinaryWriter& out) const {
+    out.write<std::int32_t>(baseId);
+    out.writeArray<Money>(cash);
+    out.writeArray<int>(inventory);
+    out.writeArray<Money>(realizedPnL);
+    out.writeArray<Money>(costBasis);
+    out.writeArray<philox::Key>(keys);
+}
+
+void NoiseTraderPopulation::loadState(BinaryReader& in) {
+    std::size_t count = size();
+    if (in.read<std::int32_t>() != baseId) {
+        throw std::runtime_error("Checkpoint population starts at a different id");
+    }
+    in.readArray(cash);
+    in.readArray(inventory);
+    in.readArray(realizedPnL);
+    in.readArray(costBasis);
+    in.readArray(keys);
+    if (cash.size() != count || keys.size() != count) {
+        throw std::runtime_error("Checkpoint population has a different size");
+    }
+}
@@ -0,0 +1,53 @@
+#include "core/AgentRegistry.hpp"
+#include <stdexcept>
+#include <string>
+
+std::uint32_t AgentRegistry::add(std::shared_ptr<Agent> agent) {
+    int id = agent->getId();
+    if (id < 0) {
+        throw std::invalid_argument("Agent id must be non-negative: " + std::to_string(id));
+    }
+    if (static_cast<std::size_t>(id) >= slotById.size()) {
+        slotById.resize(static_cast<std::size_t>(id) + 1, npos);
+    }
+    if (slotById[id] != npos) {
+        throw std::invalid_argument("Duplicate agent id: " + std::to_string(id));
+    }
+
+    auto slot = static_cast<std::uint32_t>(agents.size());
+    slotById[id] = slot;
+    agents.push_back(std::move(agent));
+    return slot;
+}
+
+void AgentRegistry::dispatchFills(std::span<const Fill> fills) {
+    if (fills.empty()) return;
+
+    // Counting sort by slot: stable, so per-agent fill order is preserved
+    fillSlots.resize(fills.size());
+    slotOffsets.assign(agents.size() + 1, 0);
+    for (std::size_t i = 0; i < fills.size(); ++i) {
+        std::uint32_t slot = slotOf(fills[i].agentId);
+        fillSlots[i] = slot;
+        if (slot != npos) ++slotOffsets[slot + 1];
+    }
+    for (std::size_t s = 0; s < agents.size(); ++s) {
+        slotOffsets[s + 1] += slotOffsets[s];
+    }
+
+    groupedFills.resize(slotOffsets[agents.size()]);
+    for (std::size_t i = 0; i < fills.size(); ++i) {
+        std::uint32_t slot = fillSlots[i];
+        if (slot != npos) groupedFills[slotOffsets[slot]++] = fills[i];
+    }
+
+    // slotOffsets[s] now marks the end of slot s's run
+    std::uint32_t begin = 0;
+    for (std::size_t s = 0; s < agents.size(); ++s) {
+        std::uint32_t end = slotOffsets[s];
+        if (end > begin) {
+            agents[s]->onFill(std::span<const Fill>(groupedFills.data() + begin, end - begin));
+        }
+        begin = end;
+    }
+}
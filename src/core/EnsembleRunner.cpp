@@ -0,0 +1,129 @@
+#include "core/EnsembleRunner.hpp"
+#include "utils/Seed.hpp"
+#include "utils/WorkStealingPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+EnsembleRunner::EnsembleRunner(const EnsembleConfig& config, Populate populate)
+    : config(config),
+      populate(std::move(populate)) {}
+
+EnsembleResults EnsembleRunner::run() {
+    unsigned threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    if (!config.recordingDir.empty()) fs::create_directories(config.recordingDir);
+
+    EnsembleResults results;
+    std::mutex resultsMutex;
+    auto start = std::chrono::steady_clock::now();
+
+    WorkStealingPool pool(threads);
+    for (std::size_t replica = 0; replica < config.replicas; ++replica) {
+        pool.submit([this, replica, &results, &resultsMutex] {
+            // Accumulate locally, then fold into the shared results once
+            EnsembleResults local;
+            runReplica(replica, local);
+
+            std::lock_guard lock(resultsMutex);
+            results.replicas += local.replicas;
+            for (auto& [type, stats] : local.pnlByType) {
+                auto [it, inserted] = results.pnlByType.try_emplace(type, stats);
+                if (!inserted) {
+                    it->second.pnl.merge(stats.pnl);
+                    it->second.pnlHistogram.merge(stats.pnlHistogram);
+                }
+            }
+            results.finalPrice.merge(local.finalPrice);
+            results.pathLow.merge(local.pathLow);
+            results.pathHigh.merge(local.pathHigh);
+            results.stepVolatility.merge(local.stepVolatility);
+            results.trades.merge(local.trades);
+        });
+    }
+    pool.wait();
+
+    results.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return results;
+}
+
+void EnsembleRunner::runReplica(std::size_t replica, EnsembleResults& into) {
+    std::uint64_t replicaSeed = deriveSeed(config.masterSeed, replica);
+
+    SimulatorConfig simConfig = config.simulator;
+    simConfig.seed = replicaSeed;
+    simConfig.recordingPath = config.recordingDir.empty()
+        ? std::string()
+        : (fs::path(config.recordingDir) / ("replica_" + std::to_string(replica) + ".bin")).string();
+
+    MarketSimulator sim(simConfig);
+    populate(sim, replicaSeed);
+
+    // Price path statistics, tracked step by step
+    const OrderBook& book = sim.getOrderBook();
+    double previous = book.getLastTradePrice();
+    double low = previous;
+    double high = previous;
+    RunningStats logReturns;
+    while (!sim.isFinished()) {
+        sim.stepSimulation();
+        double price = book.getLastTradePrice();
+        low = std::min(low, price);
+        high = std::max(high, price);
+        if (price > 0 && previous > 0) logReturns.add(std::log(price / previous));
+        previous = price;
+    }
+    sim.finish();
+
+    into.replicas = 1;
+    into.finalPrice.add(previous);
+    into.pathLow.add(low);
+    into.pathHigh.add(high);
+    into.stepVolatility.add(logReturns.stddev());
+    into.trades.add(static_cast<double>(sim.getTradeCount()));
+
+    for (const auto& agent : sim.getAgents().all()) {
+        double pnl = agent->getRealizedPnL() + agent->getUnrealizedPnL(sim.markPrice(*agent));
+        auto [it, inserted] = into.pnlByType.try_emplace(
+            agent->getType(), AgentTypeResults{{}, Histogram(config.pnlLow, config.pnlHigh, config.pnlBins)});
+        it->second.pnl.add(pnl);
+        it->second.pnlHistogram.add(pnl);
+    }
+}
+
+void EnsembleResults::print(std::ostream& out) const {
+    out << std::fixed << std::setprecision(2);
+    out << "=== ENSEMBLE COMPLETE ===\n";
+    out << "Replicas: " << replicas << " | Wall time: " << std::setprecision(3) << elapsedSeconds << " s";
+    if (elapsedSeconds > 0) {
+        out << " (" << std::setprecision(1) << replicas / elapsedSeconds << " replicas/s)";
+    }
+    out << "\n" << std::setprecision(2);
+
+    out << "PnL per agent by type:\n";
+    for (const auto& [type, stats] : pnlByType) {
+        out << "  " << type
+            << " | n: " << stats.pnl.count()
+            << " | mean: " << stats.pnl.mean()
+            << " | std: " << stats.pnl.stddev()
+            << " | p5: " << stats.pnlHistogram.quantile(0.05)
+            << " | p50: " << stats.pnlHistogram.quantile(0.50)
+            << " | p95: " << stats.pnlHistogram.quantile(0.95)
+            << " | min: " << stats.pnl.min()
+            << " | max: " << stats.pnl.max() << "\n";
+    }
+
+    out << "Final price | mean: " << finalPrice.mean() << " | std: " << finalPrice.stddev()
+        << " | min: " << finalPrice.min() << " | max: " << finalPrice.max() << "\n";
+    out << "Path range  | mean low: " << pathLow.mean() << " | mean high: " << pathHigh.mean() << "\n";
+    out << "Step vol    | mean: " << std::setprecision(6) << stepVolatility.mean()
+        << " | std: " << stepVolatility.stddev() << "\n" << std::setprecision(2);
+    out << "Trades      | mean: " << trades.mean() << " | std: " << trades.stddev()
+        << " | total: " << trades.mean() * static_cast<double>(trades.count()) << "\n";
+    out << std::flush;
+}
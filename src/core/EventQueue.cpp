@@ -0,0 +1,110 @@
+#include "core/EventQueue.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+
+// std::push_heap/pop_heap build a max-heap; invert for earliest-first
+struct LaterFirst {
+    template <typename T>
+    bool operator()(const T& a, const T& b) const {
+        if (a.event.time != b.event.time) return a.event.time > b.event.time;
+        return a.sequence > b.sequence;
+    }
+};
+
+} // namespace
+
+EventQueue::EventQueue(std::size_t horizon) {
+    std::size_t size = 64;
+    while (size < horizon) size *= 2;
+    buckets.resize(size);
+    occupancy.assign(size / 64, 0);
+}
+
+void EventQueue::push(const Event& event) {
+    if (event.time < current) {
+        throw std::invalid_argument("EventQueue::push: event scheduled in the past");
+    }
+    if (event.time - current < buckets.size()) {
+        pushToWheel(event);
+    } else {
+        far.push_back(FarEvent{event, farSequence++});
+        std::push_heap(far.begin(), far.end(), LaterFirst{});
+    }
+}
+
+void EventQueue::pushToWheel(const Event& event) {
+    std::size_t b = bucketOf(event.time);
+    buckets[b].push_back(event);
+    occupancy[b >> 6] |= 1ULL << (b & 63);
+    ++wheelCount;
+}
+
+bool EventQueue::pop(Event& out) {
+    if (!advance()) return false;
+    out = buckets[bucketOf(current)][cursor++];
+    --wheelCount;
+    return true;
+}
+
+bool EventQueue::peekTime(SimTime& time) {
+    if (!advance()) return false;
+    time = current;
+    return true;
+}
+
+bool EventQueue::advance() {
+    while (true) {
+        auto& bucket = buckets[bucketOf(current)];
+        if (cursor < bucket.size()) return true;
+
+        // Current tick is drained; keep the capacity for the next lap
+        if (!bucket.empty()) {
+            bucket.clear();
+            std::size_t b = bucketOf(current);
+            occupancy[b >> 6] &= ~(1ULL << (b & 63));
+        }
+        cursor = 0;
+
+        SimTime next;
+        if (nextBusy(next)) {
+            current = next;
+        } else if (!far.empty()) {
+            current = far.front().event.time;
+        } else {
+            return false;
+        }
+        migrate();
+    }
+}
+
+void EventQueue::migrate() {
+    while (!far.empty() && far.front().event.time - current < buckets.size()) {
+        std::pop_heap(far.begin(), far.end(), LaterFirst{});
+        pushToWheel(far.back().event);
+        far.pop_back();
+    }
+}
+
+bool EventQueue::nextBusy(SimTime& time) const {
+    if (wheelCount == 0) return false;
+
+    // Scan the bitmap cyclically, starting one bucket after the current one
+    const std::size_t mask = buckets.size() - 1;
+    const std::size_t start = (bucketOf(current) + 1) & mask;
+    const std::size_t words = occupancy.size();
+    for (std::size_t i = 0; i <= words; ++i) {
+        std::size_t w = ((start >> 6) + i) % words;
+        std::uint64_t bits = occupancy[w];
+        if (i == 0) bits &= ~0ULL << (start & 63);  // first word: from `start` on
+        if (i == words) bits &= ~(~0ULL << (start & 63));  // wrapped: only before `start`
+        if (bits) {
+            std::size_t b = (w << 6) + std::countr_zero(bits);
+            time = current + ((b - bucketOf(current)) & mask);
+            return true;
+        }
+    }
+    return false;
+}
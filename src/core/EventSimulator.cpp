@@ -0,0 +1,166 @@
+#include "core/EventSimulator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+EventSimulator::EventSimulator(const EventSimulatorConfig& config)
+    : config(config),
+      events(config.wheelHorizon),
+      recorder(config.recordInterval == 0 || config.recordingPath.empty()
+                   ? nullptr
+                   : std::make_unique<StateRecorder>(config.recordingPath)) {
+    orderBook.setSelfTradePolicy(config.selfTradePolicy);
+    if (recorder) events.push(Event{0, EventType::Record});
+}
+
+void EventSimulator::addAgent(std::shared_ptr<Agent> agent, SimTime firstWakeup) {
+    agent->setLedger(&orderBook.getLedger());
+    std::uint32_t slot = agents.add(std::move(agent));
+    latencyBySlot.resize(agents.size(), config.orderLatency);
+    events.push(Event{firstWakeup, EventType::Wakeup, slot});
+}
+
+void EventSimulator::setLatency(int agentId, SimTime latency) {
+    std::uint32_t slot = agents.slotOf(agentId);
+    if (slot == AgentRegistry::npos) {
+        throw std::invalid_argument("Unknown agent id: " + std::to_string(agentId));
+    }
+    latencyBySlot[slot] = latency;
+}
+
+void EventSimulator::scheduleTimer(SimTime time, TimerCallback callback) {
+    auto index = static_cast<std::uint32_t>(timers.size());
+    timers.push_back(std::move(callback));
+    events.push(Event{time, EventType::Timer, 0, index});
+}
+
+bool EventSimulator::step() {
+    SimTime next;
+    if (!events.peekTime(next) || next >= config.endTime) return false;
+
+    Event event;
+    events.pop(event);
+    ++eventCount;
+
+    switch (event.type) {
+    case EventType::Wakeup:
+        wake(event.target, event.time);
+        break;
+    case EventType::OrderArrival:
+        arrive(event.payload, event.time);
+        break;
+    case EventType::Timer: {
+        TimerCallback callback = std::move(timers[event.payload]);
+        callback(*this);
+        break;
+    }
+    case EventType::Record:
+        record(event.time);
+        break;
+    }
+    return true;
+}
+
+void EventSimulator::wake(std::uint32_t slot, SimTime time) {
+    Agent& agent = agents[slot];
+    auto timestamp = static_cast<long>(time);
+
+    decisions.clear();
+    agent.decide(MarketSnapshot::of(orderBook), timestamp, decisions);
+    for (const auto& intent : decisions) {
+        std::uint32_t index;
+        if (!freeInFlight.empty()) {
+            index = freeInFlight.back();
+            freeInFlight.pop_back();
+            inFlight[index] = intent;
+        } else {
+            index = static_cast<std::uint32_t>(inFlight.size());
+            inFlight.push_back(intent);
+        }
+        events.push(Event{time + latencyBySlot[slot], EventType::OrderArrival, slot, index});
+    }
+
+    long next = agent.nextWakeup(timestamp);
+    if (next >= 0) {
+        events.push(Event{std::max(static_cast<SimTime>(next), time + 1), EventType::Wakeup, slot});
+    }
+}
+
+void EventSimulator::arrive(std::uint32_t intentIndex, SimTime time) {
+    submitIntent(orderBook, inFlight[intentIndex], static_cast<long>(time));
+    freeInFlight.push_back(intentIndex);
+    deliverFills();
+}
+
+void EventSimulator::deliverFills() {
+    const auto& fills = orderBook.getRecentFills();
+    for (const auto& fill : fills) {
+        if (!fill.isAggressor) ++tradeCount;
+        std::uint32_t slot = agents.slotOf(fill.agentId);
+        if (slot != AgentRegistry::npos) agents[slot].onFill(fill);
+    }
+    orderBook.clearFills();
+}
+
+void EventSimulator::record(SimTime time) {
+    recorder->log(static_cast<long>(time), agents.all(), orderBook.getLastTradePrice());
+    events.push(Event{time + config.recordInterval, EventType::Record});
+}
+
+void EventSimulator::run() {
+    auto start = std::chrono::steady_clock::now();
+    while (step()) {}
+    elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    finish();
+    std::cout << "=== SIMULATION COMPLETE ===\n";
+    printSummary();
+}
+
+void EventSimulator::finish() {
+    if (recorder) recorder->close();
+}
+
+void EventSimulator::printSummary() const {
+    constexpr std::size_t maxAgentRows = 32;
+    double lastTradePrice = orderBook.getLastTradePrice();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "End time: " << config.endTime
+              << " | Agents: " << agents.size()
+              << " | Events: " << eventCount
+              << " | Trades: " << tradeCount
+              << " | Last Trade: " << lastTradePrice << "\n";
+    std::cout << "Wall time: " << std::setprecision(3) << elapsedSeconds << " s";
+    if (elapsedSeconds > 0) {
+        std::cout << " (" << std::setprecision(0) << eventCount / elapsedSeconds << " events/s)";
+    }
+    std::cout << "\n" << std::setprecision(2);
+
+    double totalPnL = 0.0;
+    for (const auto& agent : agents.all()) {
+        // Same marking rule as MarketSimulator::markPrice
+        int inventory = agent->getInventory();
+        double mark = inventory > 0 ? orderBook.bestBid().value_or(lastTradePrice)
+                    : inventory < 0 ? orderBook.bestAsk().value_or(lastTradePrice)
+                    : lastTradePrice;
+        double unrealized = agent->getUnrealizedPnL(mark);
+        double pnl = agent->getRealizedPnL() + unrealized;
+        totalPnL += pnl;
+        if (agents.size() <= maxAgentRows) {
+            std::cout << "Agent " << agent->getId()
+                      << " | Cash: " << agent->getCash()
+                      << " | Inventory: " << inventory
+                      << " | Realized PnL: " << agent->getRealizedPnL()
+                      << " | Unrealized PnL: " << unrealized
+                      << " | Total PnL: " << pnl << "\n";
+        }
+    }
+    if (!agents.empty()) {
+        std::cout << "Total PnL: " << totalPnL
+                  << " | Mean: " << totalPnL / static_cast<double>(agents.size()) << "\n";
+    }
+    std::cout << std::flush;
+}
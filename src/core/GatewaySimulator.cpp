@@ -0,0 +1,155 @@
+#include "core/GatewaySimulator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+GatewaySimulator::GatewaySimulator(const GatewaySimulatorConfig& config)
+    : config(config),
+      gateway(orderBook, GatewayConfig{std::max(1u, config.shards), config.ringCapacity,
+                                       config.sequenced, config.matchingCpu}),
+      shards(std::max(1u, config.shards)) {
+    orderBook.setSelfTradePolicy(config.selfTradePolicy);
+}
+
+void GatewaySimulator::addAgent(std::shared_ptr<Agent> agent) {
+    pending.push_back(std::move(agent));
+}
+
+void GatewaySimulator::run() {
+    // Contiguous blocks of agents in the order they were added
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+        std::size_t shard = i * shards.size() / pending.size();
+        gateway.route(pending[i]->getId(), shard);
+        shards[shard].agents.add(pending[i]);
+    }
+    pending.clear();
+    const MarketSnapshot market = MarketSnapshot::of(orderBook);
+    for (auto& shard : shards) shard.market = market;
+
+    auto start = std::chrono::steady_clock::now();
+    gateway.start();
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        threads.emplace_back([this, i] { runShard(i); });
+    }
+    for (auto& thread : threads) thread.join();
+    gateway.stop();
+    elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "=== SIMULATION COMPLETE ===\n";
+    printSummary();
+}
+
+void GatewaySimulator::runShard(std::size_t index) {
+    Shard& shard = shards[index];
+    OrderGateway::Port& port = gateway.port(index);
+    auto send = [&](const GatewayRequest& request) {
+        while (!port.trySend(request)) {
+            drain(shard, port);
+            std::this_thread::yield();
+        }
+    };
+    auto waitFor = [&](long batch) {
+        for (drain(shard, port); shard.closedBatch < batch; drain(shard, port)) {
+            std::this_thread::yield();
+        }
+    };
+
+    const long lastBatch = config.steps - 1;
+    for (long step = 0; step <= lastBatch; ++step) {
+        waitFor(config.sequenced ? step - 1 : step - 1 - std::max(config.maxLag, 0));
+
+        shard.intents.clear();
+        for (std::uint32_t slot = 0; slot < shard.agents.size(); ++slot) {
+            shard.agents[slot].decide(shard.market, step, shard.intents);
+        }
+        for (const auto& intent : shard.intents) {
+            send(GatewayRequest{GatewayRequest::Kind::Order, step, OrderGateway::nowNanos(), intent});
+        }
+        send(GatewayRequest{GatewayRequest::Kind::EndOfBatch, step, OrderGateway::nowNanos(), {}});
+    }
+
+    // Other shards' orders can still fill ours until every shard's last
+    // batch has closed; after that everything for us is in the ring
+    waitFor(lastBatch);
+    finishedShards.fetch_add(1, std::memory_order_acq_rel);
+    while (finishedShards.load(std::memory_order_acquire) < shards.size()) {
+        drain(shard, port);
+        std::this_thread::yield();
+    }
+    drain(shard, port);
+    shard.agents.dispatchFills(shard.fills);
+    shard.fills.clear();
+}
+
+void GatewaySimulator::drain(Shard& shard, OrderGateway::Port& port) {
+    ExecutionReport report;
+    while (port.tryReceive(report)) {
+        if (report.kind == ExecutionReport::Kind::Fill) {
+            shard.fills.push_back(report.fill);
+            continue;
+        }
+        shard.market = report.market;
+        shard.closedBatch = report.batch;
+        shard.agents.dispatchFills(shard.fills);
+        shard.fills.clear();
+    }
+}
+
+void GatewaySimulator::printSummary() const {
+    constexpr std::size_t maxAgentRows = 32;
+    double lastTradePrice = orderBook.getLastTradePrice();
+    std::size_t agentCount = 0;
+    for (const auto& shard : shards) agentCount += shard.agents.size();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Steps: " << config.steps
+              << " | Shards: " << shards.size() << (config.sequenced ? " (sequenced)" : " (free-running)")
+              << " | Agents: " << agentCount
+              << " | Orders: " << gateway.orderCount()
+              << " | Trades: " << gateway.tradeCount()
+              << " | Last Trade: " << lastTradePrice << "\n";
+    std::cout << "Wall time: " << std::setprecision(3) << elapsedSeconds << " s";
+    if (elapsedSeconds > 0) {
+        std::cout << " (" << std::setprecision(0) << gateway.orderCount() / elapsedSeconds << " orders/s)";
+    }
+    std::cout << "\n";
+
+    auto printLatency = [](const char* name, const LatencyHistogram& histogram) {
+        std::cout << name << " ns | p50: " << histogram.quantile(0.50)
+                  << " | p99: " << histogram.quantile(0.99)
+                  << " | max: " << histogram.max() << "\n";
+    };
+    printLatency("Queue latency", gateway.queueLatency());
+    printLatency("Match latency", gateway.matchLatency());
+    std::cout << std::setprecision(2);
+
+    double totalPnL = 0.0;
+    for (const auto& shard : shards) {
+        for (const auto& agent : shard.agents.all()) {
+            // Same marking rule as MarketSimulator::markPrice
+            int inventory = agent->getInventory();
+            double mark = inventory > 0 ? orderBook.bestBid().value_or(lastTradePrice)
+                        : inventory < 0 ? orderBook.bestAsk().value_or(lastTradePrice)
+                        : lastTradePrice;
+            double unrealized = agent->getUnrealizedPnL(mark);
+            double pnl = agent->getRealizedPnL() + unrealized;
+            totalPnL += pnl;
+            if (agentCount <= maxAgentRows) {
+                std::cout << "Agent " << agent->getId()
+                          << " | Cash: " << agent->getCash()
+                          << " | Inventory: " << inventory
+                          << " | Realized PnL: " << agent->getRealizedPnL()
+                          << " | Unrealized PnL: " << unrealized
+                          << " | Total PnL: " << pnl << "\n";
+            }
+        }
+    }
+    if (agentCount > 0) {
+        std::cout << "Total PnL: " << totalPnL
+                  << " | Mean: " << totalPnL / static_cast<double>(agentCount) << "\n";
+    }
+    std::cout << std::flush;
+}
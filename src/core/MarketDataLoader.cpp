@@ -0,0 +1,150 @@
+#include "core/MarketDataLoader.hpp"
+#include "core/OrderBook.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Big-endian unsigned integer of N bytes
+template <std::size_t N>
+std::uint64_t loadBE(const std::byte* p) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < N; ++i) value = (value << 8) | static_cast<std::uint8_t>(p[i]);
+    return value;
+}
+
+std::size_t requiredSize(char type) {
+    switch (type) {
+    case 'R': return itch::kStockDirectorySize;
+    case 'A': return itch::kAddSize;
+    case 'F': return itch::kAddAttributedSize;
+    case 'E': return itch::kExecutedSize;
+    case 'C': return itch::kExecutedPriceSize;
+    case 'X': return itch::kCancelSize;
+    case 'D': return itch::kDeleteSize;
+    case 'U': return itch::kReplaceSize;
+    default: return itch::kHeaderSize;
+    }
+}
+
+int shareCount(std::uint64_t shares) {
+    return static_cast<int>(std::min<std::uint64_t>(shares, INT_MAX));
+}
+
+} // namespace
+
+MarketDataLoader::MarketDataLoader(const std::string& path, std::string_view symbol)
+    : file(path),
+      data(file.bytes()) {
+    if (symbol.size() > this->symbol.size()) {
+        throw std::invalid_argument("Symbol longer than 8 characters: " + std::string(symbol));
+    }
+    filtered = !symbol.empty();
+    this->symbol.fill(' ');
+    std::copy(symbol.begin(), symbol.end(), this->symbol.begin());
+}
+
+bool MarketDataLoader::replayUntil(OrderBook& book, std::uint64_t endNanos) {
+    while (data.size() - offset >= 2) {
+        const std::byte* body = data.data() + offset + 2;
+        std::size_t size = loadBE<2>(data.data() + offset);
+        if (size > data.size() - offset - 2) {
+            throw std::runtime_error("Market data truncated at byte " + std::to_string(offset));
+        }
+        char type = static_cast<char>(body[0]);
+        if (size < requiredSize(type)) {
+            throw std::runtime_error("Malformed '" + std::string(1, type) + "' message at byte " + std::to_string(offset));
+        }
+
+        std::uint64_t timestamp = loadBE<6>(body + 5);
+        if (timestamp >= endNanos) return true;
+        offset += 2 + size;
+        ++stats.messages;
+
+        if (accepts(type, body)) {
+            apply(book, type, body, timestamp);
+        } else {
+            ++stats.skipped;
+        }
+        // Nobody consumes fills while loading
+        book.clearFills();
+    }
+    if (offset < data.size()) {
+        throw std::runtime_error("Market data truncated at byte " + std::to_string(offset));
+    }
+    return false;
+}
+
+bool MarketDataLoader::accepts(char type, const std::byte* body) {
+    if (!filtered) return true;
+    if (locate < 0) {
+        // Learn the symbol's locate code from its directory entry or first add
+        std::size_t stockAt = (type == 'R') ? 11 : (type == 'A' || type == 'F') ? 24 : 0;
+        if (stockAt == 0 || std::memcmp(body + stockAt, symbol.data(), symbol.size()) != 0) return false;
+        locate = static_cast<int>(loadBE<2>(body + 1));
+    }
+    return static_cast<int>(loadBE<2>(body + 1)) == locate;
+}
+
+void MarketDataLoader::apply(OrderBook& book, char type, const std::byte* body, std::uint64_t timestamp) {
+    auto time = static_cast<long>(timestamp);
+    std::uint64_t ref = loadBE<8>(body + 11);
+
+    switch (type) {
+    case 'A':
+    case 'F':
+        add(book, ref, body[19] == std::byte{'B'} ? OrderSide::BUY : OrderSide::SELL,
+            shareCount(loadBE<4>(body + 20)), loadBE<4>(body + 32), time);
+        ++stats.adds;
+        return;
+    case 'U': {
+        OrderHandle old = handleOf(ref);
+        const Order* order = book.findOrder(old);
+        if (!order) {
+            ++stats.unknownOrders;
+            return;
+        }
+        // Loses priority: the new order joins the back of its level
+        OrderSide side = order->side;
+        book.cancelOrder(old);
+        orders.erase(ref);
+        add(book, loadBE<8>(body + 19), side, shareCount(loadBE<4>(body + 27)), loadBE<4>(body + 31), time);
+        ++stats.replaces;
+        return;
+    }
+    case 'E':
+    case 'C':
+    case 'X':
+    case 'D':
+        break;
+    default:
+        ++stats.skipped;
+        return;
+    }
+
+    OrderHandle handle = handleOf(ref);
+    if (!book.findOrder(handle)) {
+        ++stats.unknownOrders;
+        return;
+    }
+    if (type == 'D') {
+        book.cancelOrder(handle);
+        ++stats.deletes;
+    } else if (type == 'X') {
+        book.reduceOrder(handle, shareCount(loadBE<4>(body + 19)));
+        ++stats.cancels;
+    } else {
+        book.executeOrder(handle, shareCount(loadBE<4>(body + 19)), time);
+        ++stats.executions;
+    }
+    if (!book.findOrder(handle)) orders.erase(ref);
+}
+
+void MarketDataLoader::add(OrderBook& book, std::uint64_t ref, OrderSide side, int shares,
+                           std::uint64_t price, long timestamp) {
+    Tick limit = OrderBook::limitTick(side, static_cast<double>(price) / 10000.0);
+    OrderHandle handle = book.addLimitOrder(Order{-1, kAgentId, limit, shares, side, OrderType::Limit, timestamp});
+    if (handle) orders.insert(ref, handle);
+}
@@ -1,93 +1,461 @@
 #include "core/MarketSimulator.hpp"
+#include "utils/BinaryIO.hpp"
+#include "utils/Log.hpp"
+#include "utils/MappedFile.hpp"
+#include "utils/Seed.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr std::array<char, 8> kCheckpointMagic = {'A', 'B', 'M', 'S', 'C', 'K', 'P', '\0'};
+constexpr std::uint32_t kCheckpointVersion = 6;
+
+SimulatorConfig withSteps(int steps) {
+    SimulatorConfig config;
+    config.steps = steps;
+    return config;
+}
+
+} // namespace
 
 MarketSimulator::MarketSimulator(int steps)
-    : timestamp(0),
-      maxSteps(steps),
-      logger(std::make_unique<CsvLogger>("logs/simulation.csv"))
+    : MarketSimulator(withSteps(steps)) {}
+
+MarketSimulator::MarketSimulator(const SimulatorConfig& config)
+    : config(config),
+      timestamp(0),
+      maxSteps(config.steps),
+      tradeCount(0),
+      recorder(config.recordingPath.empty() ? nullptr : std::make_unique<StateRecorder>(config.recordingPath)),
+      journal(config.journalPath.empty() ? nullptr : std::make_unique<OrderJournal>(config.journalPath))
 {
+    orderBook.setSelfTradePolicy(config.selfTradePolicy);
+    orderBook.setJournal(journal.get());
+    if (config.decisionThreads > 0) {
+        pool = std::make_unique<ThreadPool>(config.decisionThreads);
+        intentBuffers.resize(pool->size());
+    }
+    profiler.setEnabled(ABMS_PROFILING && (config.profile || !config.profileJsonPath.empty()));
 }
 
 void MarketSimulator::addAgent(std::shared_ptr<Agent> agent) {
-    agents.push_back(agent);
+    if (population && population->owns(agent->getId())) {
+        throw std::invalid_argument("Agent id inside the population's id range: " + std::to_string(agent->getId()));
+    }
+    agent->setLedger(&orderBook.getLedger());
+    agents.add(std::move(agent));
 }
 
-void MarketSimulator::stepSimulation() {
-    // Let each agent perform their actions.
-    for (auto& agent : agents) {
-        agent->act(orderBook, timestamp);
+void MarketSimulator::addPopulation(std::shared_ptr<NoiseTraderPopulation> members) {
+    if (population) {
+        throw std::invalid_argument("Simulator already has a population");
+    }
+    for (const auto& agent : agents.all()) {
+        if (members->owns(agent->getId())) {
+            throw std::invalid_argument("Agent id inside the population's id range: " + std::to_string(agent->getId()));
+        }
     }
+    members->setLedger(&orderBook.getLedger());
+    population = std::move(members);
+}
 
-    // Dispatch fills to agents.
-    const auto& fills = orderBook.getRecentFills();
-    for (const auto& fill : fills) {
-        for (auto& agent : agents) {
-            if (agent->getId() == fill.agentId) {
-                agent->onFill(fill);
-                break;
+double MarketSimulator::markPrice(const Agent& agent) const {
+    double lastTradePrice = orderBook.getLastTradePrice();
+    double marketPrice;
+    if (agent.getInventory() > 0) {
+        // Long position - use best bid (what we could sell at)
+        marketPrice = orderBook.bestBid().value_or(lastTradePrice);
+    } else if (agent.getInventory() < 0) {
+        // Short position - use best ask (what we could buy at)
+        marketPrice = orderBook.bestAsk().value_or(lastTradePrice);
+    } else {
+        // Flat position - use last trade price
+        marketPrice = lastTradePrice;
+    }
+
+    // Fallback to default if no prices available
+    if (marketPrice == 0) {
+        marketPrice = 100.0;
+        ABMS_LOG(LogLevel::Warn, LogCategory::Step,
+                 "Warning: Using default price of 100.0 for PnL calculations (no market data available)\n");
+    }
+    return marketPrice;
+}
+
+void MarketSimulator::decideInParallel() {
+    const MarketSnapshot snapshot = MarketSnapshot::of(orderBook);
+    intentRanges.resize(agents.size());
+    for (auto& buffer : intentBuffers) buffer.clear();
+
+    pool->parallelFor(agents.size(), [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        auto& buffer = intentBuffers[chunk];
+        for (std::size_t slot = begin; slot < end; ++slot) {
+            auto first = static_cast<std::uint32_t>(buffer.size());
+            agents[static_cast<std::uint32_t>(slot)].decide(snapshot, timestamp, buffer);
+            intentRanges[slot] = IntentRange{static_cast<std::uint32_t>(chunk), first,
+                                             static_cast<std::uint32_t>(buffer.size())};
+        }
+    });
+
+    if (population) {
+        pool->parallelFor(population->size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+            population->decideRange(begin, end, timestamp, snapshot);
+        });
+    }
+}
+
+void MarketSimulator::applyIntents() {
+    // Fisher-Yates over agent slots, keyed by (seed, timestamp) only, so the
+    // order does not depend on how the decision phase was scheduled
+    std::uint64_t state = config.seed ^ (static_cast<std::uint64_t>(timestamp) * 0xD1B54A32D192ED03ULL);
+    matchOrder.resize(agents.size() + (population ? population->size() : 0));
+    for (std::size_t i = 0; i < matchOrder.size(); ++i) {
+        matchOrder[i] = static_cast<std::uint32_t>(i);
+    }
+    for (std::size_t i = matchOrder.size(); i > 1; --i) {
+        std::size_t j = splitmix64(state) % i;
+        std::swap(matchOrder[i - 1], matchOrder[j]);
+    }
+
+    // Plain orders go to the book in one batch; a cancel or ORDER intent
+    // flushes it and is applied alone, its fills moved over in book order
+    auto apply = [&](const OrderIntent& intent) {
+        if (auto order = asOrder(intent, timestamp)) {
+            batch.push_back(*order);
+            return;
+        }
+        flushBatch();
+        submitIntent(orderBook, intent, timestamp);
+        const auto& fills = orderBook.getRecentFills();
+        stepFills.insert(stepFills.end(), fills.begin(), fills.end());
+        orderBook.clearFills();
+    };
+
+    const auto agentSlots = static_cast<std::uint32_t>(agents.size());
+    for (std::uint32_t slot : matchOrder) {
+        if (slot >= agentSlots) {
+            if (const OrderIntent* intent = population->intentOf(slot - agentSlots)) apply(*intent);
+            continue;
+        }
+        const IntentRange& range = intentRanges[slot];
+        const auto& buffer = intentBuffers[range.chunk];
+        for (std::uint32_t i = range.begin; i < range.end; ++i) apply(buffer[i]);
+    }
+    flushBatch();
+}
+
+void MarketSimulator::flushBatch() {
+    if (batch.empty()) return;
+    if (ABMS_LOG_ENABLED(LogLevel::Debug, LogCategory::Fill)) {
+        auto logFill = [&](const Fill& fill) {
+            if (fill.isAggressor) {
+                ABMS_LOG(LogLevel::Debug, LogCategory::Fill,
+                         "  -> Agent " << fill.agentId << " filled " << fill.quantity
+                         << " @ " << std::fixed << std::setprecision(2) << OrderBook::toPrice(fill.price) << "\n");
+            }
+            stepFills.push_back(fill);
+        };
+        orderBook.submitBatch(batch, FillSink(logFill));
+    } else {
+        orderBook.submitBatch(batch, stepFills);
+    }
+    batch.clear();
+}
+
+void MarketSimulator::stepSimulation() {
+    Profiler::Activation activation(profiler);
+    {
+        ABMS_PROFILE_SCOPE(Phase::Step);
+
+        if (pool) {
+            // Two-phase: parallel decisions, deterministic sequential matching
+            {
+                ABMS_PROFILE_SCOPE(Phase::AgentAct);
+                decideInParallel();
+            }
+            applyIntents();
+        } else {
+            // Let each agent perform their actions.
+            ABMS_PROFILE_SCOPE(Phase::AgentAct);
+            for (auto& agent : agents.all()) {
+                agent->act(orderBook, timestamp);
             }
+            if (population) actPopulation();
         }
+
+        // Dispatch fills to agents.
+        {
+            ABMS_PROFILE_SCOPE(Phase::FillDispatch);
+            // A two-phase step's fills were collected by applyIntents
+            std::span<const Fill> fills = pool ? std::span<const Fill>(stepFills) : orderBook.getRecentFills();
+            tradeCount += std::count_if(fills.begin(), fills.end(),
+                                        [](const Fill& fill) { return !fill.isAggressor; });
+            dispatchFills(fills);
+            stepFills.clear();
+            orderBook.clearFills();
+        }
+
+        report();
     }
-    orderBook.clearFills();
+    profiler.endStep();
+    timestamp++;
+}
 
+void MarketSimulator::actPopulation() {
+    // Draws are batched; each member still sees the book as left by the previous one
+    population->drawBatch(0, population->size(), timestamp);
+    OrderIntent intent{};
+    for (std::size_t i = 0; i < population->size(); ++i) {
+        if (population->decide(i, MarketSnapshot::of(orderBook), intent)) {
+            submitIntent(orderBook, intent, timestamp);
+        }
+    }
+}
+
+void MarketSimulator::dispatchFills(std::span<const Fill> fills) {
+    agents.dispatchFills(fills);  // drops population ids
+    if (!population) return;
+    for (const auto& fill : fills) {
+        if (population->owns(fill.agentId)) population->onFill(fill);
+    }
+}
+
+void MarketSimulator::report() {
     // Get the market price for PnL calculations
     double lastTradePrice = orderBook.getLastTradePrice();
-    auto bestBid = orderBook.bestBid();
-    auto bestAsk = orderBook.bestAsk();
-    
-    std::cout << "\nMarket prices for PnL calculations:\n";
-    std::cout << "Last Trade: " << std::fixed << std::setprecision(2) << lastTradePrice << "\n";
-    if (bestBid) std::cout << "Best Bid: " << *bestBid << "\n";
-    if (bestAsk) std::cout << "Best Ask: " << *bestAsk << "\n";
+
+    if (ABMS_LOG_ENABLED(LogLevel::Debug, LogCategory::Step)) {
+        auto bestBid = orderBook.bestBid();
+        auto bestAsk = orderBook.bestAsk();
+        std::cout << "\nMarket prices for PnL calculations:\n";
+        std::cout << "Last Trade: " << std::fixed << std::setprecision(2) << lastTradePrice << "\n";
+        if (bestBid) std::cout << "Best Bid: " << *bestBid << "\n";
+        if (bestAsk) std::cout << "Best Ask: " << *bestAsk << "\n";
+    }
 
     // Log the current state.
-    logger->log(timestamp, agents, lastTradePrice);
+    if (recorder) {
+        ABMS_PROFILE_SCOPE(Phase::Recording);
+        recorder->log(timestamp, agents.all(), lastTradePrice);
+    }
 
-    std::cout << "--- Timestamp: " << timestamp << " ---\n";
-    orderBook.printBook();
+    ABMS_LOG(LogLevel::Info, LogCategory::Step, "--- Timestamp: " << timestamp << " ---\n");
+    if (ABMS_LOG_ENABLED(LogLevel::Debug, LogCategory::Book)) {
+        ABMS_PROFILE_SCOPE(Phase::BookPrint);
+        orderBook.printBook();
+    }
 
-    std::cout << std::fixed << std::setprecision(2);
-    for (const auto& agent : agents) {
-        double marketPrice;
-        if (agent->getInventory() > 0) {
-            // Long position - use best bid (what we could sell at)
-            marketPrice = bestBid.value_or(lastTradePrice);
-        } else if (agent->getInventory() < 0) {
-            // Short position - use best ask (what we could buy at)
-            marketPrice = bestAsk.value_or(lastTradePrice);
-        } else {
-            // Flat position - use last trade price
-            marketPrice = lastTradePrice;
+    if (ABMS_LOG_ENABLED(LogLevel::Debug, LogCategory::Agent)) {
+        ABMS_PROFILE_SCOPE(Phase::PnLValuation);
+        std::cout << std::fixed << std::setprecision(2);
+        for (const auto& agent : agents.all()) {
+            double unrealized = agent->getUnrealizedPnL(markPrice(*agent));
+            std::cout << "Agent " << agent->getId()
+                      << " | Cash: " << agent->getCash()
+                      << " (Available: " << agent->getAvailableCash() << ")"
+                      << " | Inventory: " << agent->getInventory()
+                      << " (Available: " << agent->getAvailableInventory() << ")"
+                      << " | Realized PnL: " << agent->getRealizedPnL()
+                      << " | Unrealized PnL: " << unrealized
+                      << " | Total PnL: " << agent->getRealizedPnL() + unrealized
+                      << "\n";
         }
-        
-        // Fallback to default if no prices available
-        if (marketPrice == 0) {
-            marketPrice = 100.0;
-            std::cout << "Warning: Using default price of 100.0 for PnL calculations (no market data available)\n";
-        }
-        
-        double unrealized = agent->getUnrealizedPnL(marketPrice);
-        std::cout << "Agent " << agent->getId()
-                  << " | Cash: " << agent->getCash()
-                  << " (Available: " << agent->getAvailableCash() << ")"
-                  << " | Inventory: " << agent->getInventory()
-                  << " (Available: " << agent->getAvailableInventory() << ")"
-                  << " | Realized PnL: " << agent->getRealizedPnL()
-                  << " | Unrealized PnL: " << unrealized
-                  << " | Total PnL: " << agent->getRealizedPnL() + unrealized
-                  << std::endl;
-    }
-    
-    std::cout << std::endl;
-    timestamp++;
+        std::cout << "\n";
+    }
 }
 
 void MarketSimulator::run() {
-    while (timestamp < maxSteps) {
+    auto start = std::chrono::steady_clock::now();
+    while (!isFinished()) {
         stepSimulation();
     }
-    logger->close();
+    elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    finish();
     std::cout << "=== SIMULATION COMPLETE ===\n";
+    printSummary();
+
+    if (profiler.isEnabled()) {
+        printProfile(std::cout);
+        if (!config.profileJsonPath.empty()) {
+            std::ofstream json(config.profileJsonPath);
+            if (json) {
+                profiler.writeJson(json);
+            } else {
+                ABMS_LOG(LogLevel::Error, LogCategory::General,
+                         "Cannot write profile to " << config.profileJsonPath << "\n");
+            }
+        }
+    }
+}
+
+void MarketSimulator::printProfile(std::ostream& out) {
+    if (!profiler.isEnabled()) return;
+    const BookStats& stats = orderBook.getStats();
+    profiler.setCounter("orders_placed", stats.ordersPlaced);
+    profiler.setCounter("fills", stats.fills);
+    profiler.setCounter("cancels", stats.cancels);
+    profiler.setCounter("levels_touched", stats.levelsTouched);
+    profiler.setCounter("self_trades", stats.selfTrades);
+    profiler.setCounter("stops_triggered", stats.stopsTriggered);
+    profiler.setCounter("band_rejects", stats.bandRejects);
+    profiler.setCounter("fok_rejects", stats.fokRejects);
+    profiler.printSummary(out);
+    out << std::flush;
+}
+
+void MarketSimulator::saveCheckpoint(const std::string& path) const {
+    BinaryWriter out;
+    out.write(kCheckpointMagic);
+    out.write(kCheckpointVersion);
+    out.write<std::int32_t>(timestamp);
+    out.write<std::int64_t>(tradeCount);
+    out.write<std::uint64_t>(config.seed);
+    orderBook.saveState(out);
+
+    // Each agent's state as its own block, so a type mismatch on load shows
+    // up as a size mismatch instead of misreading everything after it
+    BinaryWriter agentOut;
+    out.write<std::uint64_t>(agents.size());
+    for (const auto& agent : agents.all()) {
+        agentOut.clear();
+        agent->saveState(agentOut);
+        out.write<std::int32_t>(agent->getId());
+        out.writeString(agent->getType());
+        out.writeBlock(agentOut.bytes());
+    }
+
+    out.write<std::uint8_t>(population ? 1 : 0);
+    if (population) population->saveState(out);
+
+    out.saveTo(path);
+}
+
+void MarketSimulator::loadCheckpoint(const std::string& path) {
+    MappedFile file(path);
+    BinaryReader in(file.bytes());
+
+    if (in.read<std::array<char, 8>>() != kCheckpointMagic || in.read<std::uint32_t>() != kCheckpointVersion) {
+        throw std::runtime_error("Not a simulation checkpoint: " + path);
+    }
+    timestamp = in.read<std::int32_t>();
+    tradeCount = static_cast<long>(in.read<std::int64_t>());
+    config.seed = in.read<std::uint64_t>();
+    orderBook.loadState(in);
+
+    auto agentCount = in.read<std::uint64_t>();
+    for (std::uint64_t n = 0; n < agentCount; ++n) {
+        int id = in.read<std::int32_t>();
+        std::string type = in.readString();
+        BinaryReader agentIn(in.readBlock());
+
+        std::uint32_t slot = agents.slotOf(id);
+        if (slot == AgentRegistry::npos) {
+            throw std::runtime_error("Checkpoint agent " + std::to_string(id) + " is not in the simulation");
+        }
+        Agent& agent = agents[slot];
+        if (type != agent.getType()) {
+            throw std::runtime_error("Checkpoint agent " + std::to_string(id) + " is a " + type
+                                     + ", not a " + agent.getType());
+        }
+        agent.loadState(agentIn);
+        if (agentIn.remaining() != 0) {
+            throw std::runtime_error("Checkpoint state of agent " + std::to_string(id) + " has an unexpected size");
+        }
+    }
+
+    bool hasPopulation = in.read<std::uint8_t>() != 0;
+    if (hasPopulation != static_cast<bool>(population)) {
+        throw std::runtime_error("Checkpoint and simulation disagree on the population");
+    }
+    if (population) population->loadState(in);
+}
+
+void MarketSimulator::seedFromMarketData(MarketDataLoader& loader, std::uint64_t endNanos) {
+    loader.replayUntil(orderBook, endNanos);
+    orderBook.clearFills();
+    orderBook.clearAgentActionFlag();
+}
+
+void MarketSimulator::finish() {
+    if (recorder) recorder->close();
+    if (journal) {
+        orderBook.setJournal(nullptr);
+        journal->close();
+    }
+}
+
+void MarketSimulator::printSummary() const {
+    // Always printed, regardless of log level; this is the headless output
+    constexpr std::size_t maxAgentRows = 32;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Steps: " << timestamp
+              << " | Agents: " << agents.size() + (population ? population->size() : 0)
+              << " | Trades: " << tradeCount
+              << " | Last Trade: " << orderBook.getLastTradePrice() << "\n";
+    std::cout << "Wall time: " << std::setprecision(3) << elapsedSeconds << " s";
+    if (elapsedSeconds > 0) {
+        std::cout << " (" << std::setprecision(0) << timestamp / elapsedSeconds << " steps/s)";
+    }
+    std::cout << "\n" << std::setprecision(2);
+
+    double totalPnL = 0.0;
+    double bestPnL = 0.0;
+    double worstPnL = 0.0;
+    for (std::size_t slot = 0; slot < agents.size(); ++slot) {
+        const Agent& agent = agents[static_cast<std::uint32_t>(slot)];
+        double unrealized = agent.getUnrealizedPnL(markPrice(agent));
+        double pnl = agent.getRealizedPnL() + unrealized;
+        totalPnL += pnl;
+        bestPnL = (slot == 0) ? pnl : std::max(bestPnL, pnl);
+        worstPnL = (slot == 0) ? pnl : std::min(worstPnL, pnl);
+
+        if (agents.size() <= maxAgentRows) {
+            std::cout << "Agent " << agent.getId()
+                      << " | Cash: " << agent.getCash()
+                      << " | Inventory: " << agent.getInventory()
+                      << " | Realized PnL: " << agent.getRealizedPnL()
+                      << " | Unrealized PnL: " << unrealized
+                      << " | Total PnL: " << pnl << "\n";
+        }
+    }
+    if (!agents.empty()) {
+        std::cout << "Total PnL: " << totalPnL
+                  << " | Mean: " << totalPnL / static_cast<double>(agents.size())
+                  << " | Best: " << bestPnL
+                  << " | Worst: " << worstPnL << "\n";
+    }
+
+    if (population && population->size() > 0) {
+        // Same marking rule as markPrice, per sign of the position
+        double lastTradePrice = orderBook.getLastTradePrice();
+        double longMark = orderBook.bestBid().value_or(lastTradePrice);
+        double shortMark = orderBook.bestAsk().value_or(lastTradePrice);
+
+        double populationPnL = 0.0;
+        double best = 0.0;
+        double worst = 0.0;
+        for (std::size_t i = 0; i < population->size(); ++i) {
+            int inventory = population->getInventory(i);
+            double mark = inventory > 0 ? longMark : inventory < 0 ? shortMark : lastTradePrice;
+            double pnl = population->getRealizedPnL(i) + population->getUnrealizedPnL(i, mark);
+            populationPnL += pnl;
+            best = (i == 0) ? pnl : std::max(best, pnl);
+            worst = (i == 0) ? pnl : std::min(worst, pnl);
+        }
+        std::cout << "Population: " << population->size() << " noise traders"
+                  << " | Total PnL: " << populationPnL
+                  << " | Mean: " << populationPnL / static_cast<double>(population->size())
+                  << " | Best: " << best
+                  << " | Worst: " << worst << "\n";
+    }
+    std::cout << std::flush;
 }
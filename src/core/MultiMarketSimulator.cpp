@@ -0,0 +1,174 @@
+#include "core/MultiMarketSimulator.hpp"
+#include "utils/Log.hpp"
+#include "utils/Seed.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr std::uint32_t kNoSlot = static_cast<std::uint32_t>(-1);
+
+} // namespace
+
+MultiMarketSimulator::MultiMarketSimulator(const MultiSimulatorConfig& config)
+    : config(config),
+      timestamp(0),
+      tradeCount(0),
+      books(config.instruments),
+      pool(std::max(1u, config.threads)),
+      snapshots(config.instruments),
+      intentBuffers(pool.size()),
+      bookIntents(config.instruments),
+      executions(config.instruments) {
+    for (auto& book : books) book.setSelfTradePolicy(config.selfTradePolicy);
+}
+
+void MultiMarketSimulator::addAgent(std::shared_ptr<MultiAssetAgent> agent) {
+    int id = agent->getId();
+    if (id < 0) {
+        throw std::invalid_argument("Agent id must be non-negative: " + std::to_string(id));
+    }
+    if (agent->getInstrumentCount() != books.size()) {
+        throw std::invalid_argument("Agent " + std::to_string(id) + " does not cover every instrument");
+    }
+    if (static_cast<std::size_t>(id) >= slotById.size()) {
+        slotById.resize(static_cast<std::size_t>(id) + 1, kNoSlot);
+    }
+    if (slotById[id] != kNoSlot) {
+        throw std::invalid_argument("Duplicate agent id: " + std::to_string(id));
+    }
+    std::vector<const RiskLedger*> ledgers;
+    for (const auto& book : books) ledgers.push_back(&book.getLedger());
+    agent->setLedgers(std::move(ledgers));
+    slotById[id] = static_cast<std::uint32_t>(agents.size());
+    agents.push_back(std::move(agent));
+}
+
+void MultiMarketSimulator::decideInParallel() {
+    for (std::size_t i = 0; i < books.size(); ++i) {
+        snapshots[i] = MarketSnapshot::of(books[i]);
+    }
+    for (auto& buffer : intentBuffers) buffer.clear();
+
+    pool.parallelFor(agents.size(), [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        for (std::size_t slot = begin; slot < end; ++slot) {
+            agents[slot]->decide(snapshots, timestamp, intentBuffers[chunk]);
+        }
+    });
+}
+
+void MultiMarketSimulator::routeIntents() {
+    for (auto& queue : bookIntents) queue.clear();
+
+    // Chunks cover agent slots in order, so this is agent-slot order
+    for (const auto& buffer : intentBuffers) {
+        for (const auto& routed : buffer) {
+            if (routed.instrument < bookIntents.size()) {
+                bookIntents[routed.instrument].push_back(routed.intent);
+            }
+        }
+    }
+
+    // Per-book arrival order is a seeded shuffle, as in MarketSimulator
+    for (std::size_t i = 0; i < bookIntents.size(); ++i) {
+        auto& queue = bookIntents[i];
+        std::uint64_t state = config.seed
+            ^ (static_cast<std::uint64_t>(timestamp) * 0xD1B54A32D192ED03ULL)
+            ^ (static_cast<std::uint64_t>(i + 1) * 0x9E3779B97F4A7C15ULL);
+        for (std::size_t k = queue.size(); k > 1; --k) {
+            std::swap(queue[k - 1], queue[splitmix64(state) % k]);
+        }
+    }
+}
+
+void MultiMarketSimulator::matchInParallel() {
+    pool.parallelFor(books.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            OrderBook& book = books[i];
+            auto& out = executions[i];
+            out.clear();
+
+            // Both sides of every match, in the order they happened
+            for (const auto& intent : bookIntents[i]) {
+                submitIntent(book, intent, timestamp);
+                const auto& fills = book.getRecentFills();
+                out.insert(out.end(), fills.begin(), fills.end());
+                book.clearFills();
+            }
+        }
+    });
+}
+
+void MultiMarketSimulator::settle() {
+    for (std::size_t i = 0; i < executions.size(); ++i) {
+        for (const Fill& fill : executions[i]) {
+            if (!fill.isAggressor) ++tradeCount;
+            if (fill.agentId < 0 || static_cast<std::size_t>(fill.agentId) >= slotById.size()) continue;
+            std::uint32_t slot = slotById[fill.agentId];
+            if (slot != kNoSlot) agents[slot]->onFill(i, fill);
+        }
+    }
+    for (auto& agent : agents) agent->clearCommitments();
+}
+
+void MultiMarketSimulator::stepSimulation() {
+    decideInParallel();
+    routeIntents();
+    matchInParallel();  // returns once every book has matched: the step barrier
+    settle();
+
+    if (ABMS_LOG_ENABLED(LogLevel::Info, LogCategory::Step)) {
+        std::cout << "--- Timestamp: " << timestamp << " ---\n" << std::fixed << std::setprecision(2);
+        for (std::size_t i = 0; i < books.size(); ++i) {
+            std::cout << "Instrument " << i << " | Last Trade: " << books[i].getLastTradePrice() << "\n";
+        }
+    }
+    timestamp++;
+}
+
+void MultiMarketSimulator::run() {
+    auto start = std::chrono::steady_clock::now();
+    while (timestamp < config.steps) {
+        stepSimulation();
+    }
+    elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "=== SIMULATION COMPLETE ===\n";
+    printSummary();
+}
+
+void MultiMarketSimulator::printSummary() const {
+    std::vector<double> marks(books.size());
+    for (std::size_t i = 0; i < books.size(); ++i) {
+        marks[i] = books[i].getLastTradePrice();
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Steps: " << timestamp
+              << " | Instruments: " << books.size()
+              << " | Agents: " << agents.size()
+              << " | Threads: " << pool.size()
+              << " | Trades: " << tradeCount << "\n";
+    std::cout << "Wall time: " << std::setprecision(3) << elapsedSeconds << " s";
+    if (elapsedSeconds > 0) {
+        std::cout << " (" << std::setprecision(0) << timestamp / elapsedSeconds << " steps/s)";
+    }
+    std::cout << "\n" << std::setprecision(2);
+
+    for (std::size_t i = 0; i < books.size() && i < 32; ++i) {
+        std::cout << "Instrument " << i << " | Last Trade: " << marks[i] << "\n";
+    }
+
+    double totalPnL = 0.0;
+    for (const auto& agent : agents) {
+        totalPnL += agent->getRealizedPnL() + agent->getUnrealizedPnL(marks);
+    }
+    if (!agents.empty()) {
+        std::cout << "Total PnL: " << totalPnL
+                  << " | Mean: " << totalPnL / static_cast<double>(agents.size()) << "\n";
+    }
+    std::cout << std::flush;
+}
@@ -1,243 +1,593 @@
+#include "core/Order.hpp"
 #include "core/OrderBook.hpp"
+#include "core/OrderJournal.hpp"
+#include "utils/BinaryIO.hpp"
+#include "utils/Profiler.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iomanip>  // for setprecision
 
-OrderBook::OrderBook() 
-    : lastTradePrice(100.0),  // Initialize with a reasonable default
-      actionTakenByAgentId(-1) {}
+namespace {
 
-void OrderBook::addLimitOrder(const Order& order) {
-    int remainingQty = order.quantity;
-    
-    // First check if order can be immediately matched
-    if (order.side == OrderSide::BUY && !asks.empty() && order.price >= asks.begin()->first) {
-        auto fills = matchMarketOrder(order);
-        if (!fills.empty()) {
-            // Track remaining quantity
-            for (const auto& fill : fills) {
-                remainingQty -= fill.quantity;
-            }
-            // If order was fully filled, we're done
-            if (remainingQty == 0) {
-                return;
-            }
+// Stop orders waiting in the trigger book
+bool isParked(const Order& order) {
+    return order.type == OrderType::Stop || order.type == OrderType::StopLimit;
+}
+
+} // namespace
+
+template <typename Config>
+BasicOrderBook<Config>::BasicOrderBook()
+    : bids(Ladder::Touch::Highest, toTicks(100.0)),
+      asks(Ladder::Touch::Lowest, toTicks(100.0)),
+      nextOrderId(1),
+      lastTradeTick(toTicks(100.0)),  // Initialize with a reasonable default
+      actionTakenByAgentId(-1),
+      ledger(kMoneyPerTick) {}
+
+template <typename Config>
+OrderHandle BasicOrderBook<Config>::addLimitOrder(const Order& order, FillSink executions) {
+    Order limitOrder = order;
+    limitOrder.type = OrderType::Limit;
+    return submitOrder(limitOrder, executions);
+}
+
+template <typename Config>
+OrderHandle BasicOrderBook<Config>::submitOrder(const Order& order, const OrderParams& params,
+                                                FillSink executions) {
+    if (order.type == OrderType::Market) {
+        matchMarketOrder(order, executions);
+        return {};
+    }
+
+    if (journal) journal->recordOrder(journal::RecordType::Limit, order, params);
+    if (order.quantity <= 0) return {};
+    // A plain Stop has no limit price, only a trigger
+    bool outside = (order.type != OrderType::Stop && !inBand(order.price))
+                   || (isParked(order) && !inBand(params.stopPrice));
+    if (outside) {
+        ABMS_COUNT(++stats.bandRejects);
+        return {};
+    }
+    ABMS_COUNT(++stats.ordersPlaced);
+
+    OrderHandle handle = place(order, params, executions);
+    fireStops(order.timestamp);
+    return handle;
+}
+
+template <typename Config>
+OrderHandle BasicOrderBook<Config>::place(const Order& order, const OrderParams& params, FillSink executions) {
+    Order incoming = order;
+    Tick tick = order.price;
+
+    switch (order.type) {
+    case OrderType::Stop:
+    case OrderType::StopLimit:
+        incoming.id = nextOrderId++;
+        actionTakenByAgentId = order.agentId;
+        return pool.handleOf(park(incoming, params.stopPrice));
+    case OrderType::FOK:
+        if (!canFill(incoming, tick)) {
+            ABMS_COUNT(++stats.fokRejects);
+            return {};
         }
+        [[fallthrough]];
+    case OrderType::IOC:
+        if (order.agentId >= 0) {
+            actionTakenByAgentId = order.agentId;
+            sweep(incoming, tick, executions);
+        }
+        return {};
+    default:
+        break;
     }
-    else if (order.side == OrderSide::SELL && !bids.empty() && order.price <= bids.rbegin()->first) {
-        auto fills = matchMarketOrder(order);
-        if (!fills.empty()) {
-            // Track remaining quantity
-            for (const auto& fill : fills) {
-                remainingQty -= fill.quantity;
-            }
-            // If order was fully filled, we're done
-            if (remainingQty == 0) {
-                return;
-            }
+
+    // Limit and Iceberg: match what crosses, rest the remainder
+    int remainingQty = order.quantity;
+    auto opposite = (order.side == OrderSide::BUY) ? asks.lowest() : bids.highest();
+    bool crosses = opposite && ((order.side == OrderSide::BUY) ? tick >= *opposite : tick <= *opposite);
+    if (crosses && order.agentId >= 0) {
+        actionTakenByAgentId = order.agentId;
+        remainingQty = sweep(incoming, tick, executions).remaining;
+        // If order was fully filled (or cancelled by self-trade prevention), we're done
+        if (remainingQty == 0) {
+            return {};
         }
     }
 
     // If we get here, either no matching or partial fill - add remaining to book
-    static int nextOrderId = 1;
-    Order orderWithId = order;
-    orderWithId.id = nextOrderId++;
-    orderWithId.quantity = remainingQty;  // Update with remaining quantity
-    
+    incoming.id = nextOrderId++;
+    int reserve = 0;
+    int display = params.displayQuantity;
+    if (order.type == OrderType::Iceberg && display > 0 && display < remainingQty) {
+        reserve = remainingQty - display;
+        remainingQty = display;
+    }
+    incoming.quantity = remainingQty;
+
     // Add order to the book
-    idLookup[orderWithId.id] = orderWithId;
-    auto& book = (orderWithId.side == OrderSide::BUY) ? bids : asks;
-    book[orderWithId.price].push_back(orderWithId);
-    
+    OrderIndex index = rest(incoming, reserve, display);
+
     // Mark the agent as having taken action
-    actionTakenByAgentId = orderWithId.agentId;
-    
-    // Create a reservation fill for tracking purposes
-    recentFills.emplace_back(Fill{
-        .agentId = orderWithId.agentId,
-        .price = orderWithId.price,
-        .quantity = orderWithId.quantity,
-        .side = orderWithId.side,
-        .timestamp = orderWithId.timestamp,
-        .isReservation = true
+    actionTakenByAgentId = incoming.agentId;
+
+    return pool.handleOf(index);
+}
+
+template <typename Config>
+OrderIndex BasicOrderBook<Config>::rest(const Order& order, int reserve, int display) {
+    OrderIndex index = pool.allocate(order, order.price);
+    pool[index].reserve = reserve;
+    pool[index].display = display;
+    idLookup.insert(order.id, index);
+    link(index);
+    return index;
+}
+
+template <typename Config>
+void BasicOrderBook<Config>::link(OrderIndex index) {
+    const auto& node = pool[index];
+    const Order& order = node.order;
+    auto& level = ((order.side == OrderSide::BUY) ? bids : asks).acquire(node.tick);
+    pool.pushBack(level.queue, index);
+    level.totalQuantity += order.quantity;
+    ++level.orderCount;
+    ledger.reserve(order.agentId, order.side, order.quantity + node.reserve, node.tick);
+    auto& owners = (order.side == OrderSide::BUY) ? bidOwners : askOwners;
+    owners.update(order.agentId, node.tick, order.quantity, 1);
+}
+
+template <typename Config>
+template <typename Side>
+bool BasicOrderBook<Config>::takeQuantity(OrderIndex index, typename Ladder::Level& level, int quantity) {
+    auto& node = pool[index];
+    Order& order = node.order;
+    auto& owners = Side::resting(bidOwners, askOwners);
+
+    order.quantity -= quantity;
+    level.totalQuantity -= quantity;
+    ledger.release(order.agentId, order.side, quantity, node.tick);
+    if (order.quantity > 0) {
+        owners.update(order.agentId, node.tick, -quantity, 0);
+        return true;
+    }
+
+    if (node.reserve > 0) {
+        // Iceberg: show the next slice, behind everything already queued
+        int slice = std::min(node.display, node.reserve);
+        node.reserve -= slice;
+        order.quantity = slice;
+        level.totalQuantity += slice;
+        owners.update(order.agentId, node.tick, slice - quantity, 0);
+        pool.unlink(level.queue, index);
+        pool.pushBack(level.queue, index);
+        return true;
+    }
+
+    owners.update(order.agentId, node.tick, -quantity, -1);
+    idLookup.erase(order.id);
+    pool.unlink(level.queue, index);
+    pool.release(index);
+    --level.orderCount;
+    return false;
+}
+
+template <typename Config>
+void BasicOrderBook<Config>::takeQuantity(OrderIndex index, int quantity) {
+    Tick tick = pool[index].tick;
+    withSide(pool[index].order.side, [&]<typename Side>(Side) {
+        auto& book = Side::resting(bids, asks);
+        auto& level = *book.find(tick);
+        takeQuantity<Side>(index, level, quantity);
+        if (level.queue.empty()) book.release(tick);
     });
 }
 
-bool OrderBook::cancelOrder(int orderId) {
-    auto it = idLookup.find(orderId);
-    if (it == idLookup.end()) return false;
-
-    const Order& order = it->second;
-    auto& book = (order.side == OrderSide::BUY) ? bids : asks;
-
-    auto priceIt = book.find(order.price);
-    if (priceIt != book.end()) {
-        auto& queue = priceIt->second;
-        for (auto qIt = queue.begin(); qIt != queue.end(); ++qIt) {
-            if (qIt->id == orderId) {
-                // Create reservation cancellation fill
-                recentFills.emplace_back(Fill{
-                    .agentId = order.agentId,
-                    .price = order.price,
-                    .quantity = order.quantity,
-                    .side = order.side,
-                    .timestamp = order.timestamp,
-                    .isReservation = true,
-                    .isCancellation = true
-                });
-                
-                // Remove the order
-                queue.erase(qIt);
-                idLookup.erase(orderId);
-                
-                // Clean up empty price levels
-                if (queue.empty()) book.erase(priceIt);
-                
-                // Mark the agent as having taken action
-                actionTakenByAgentId = order.agentId;
-                
-                return true;
-            }
-        }
+template <typename Config>
+OrderIndex BasicOrderBook<Config>::park(const Order& order, Tick stopTick) {
+    OrderIndex index = pool.allocate(order, stopTick);
+    idLookup.insert(order.id, index);
+    stops.add(order.side, pool[index].tick, index);
+    return index;
+}
+
+template <typename Config>
+void BasicOrderBook<Config>::unpark(OrderIndex index) {
+    const auto& node = pool[index];
+    stops.remove(node.order.side, node.tick, index);
+    idLookup.erase(node.order.id);
+    pool.release(index);
+}
+
+template <typename Config>
+void BasicOrderBook<Config>::fireStops(long timestamp) {
+    // A released order can trade and move the price into further stops
+    while (!stops.empty()) {
+        triggered.clear();
+        stops.collect(lastTradeTick, triggered);
+        if (triggered.empty()) return;
+        for (OrderIndex index : triggered) trigger(index, timestamp);
+    }
+}
+
+template <typename Config>
+void BasicOrderBook<Config>::trigger(OrderIndex index, long timestamp) {
+    ABMS_COUNT(++stats.stopsTriggered);
+    Order order = pool[index].order;
+    order.timestamp = timestamp;
+
+    if (order.type == OrderType::Stop) {
+        idLookup.erase(order.id);
+        pool.release(index);
+        order.type = OrderType::Market;
+        if (order.agentId >= 0) sweep(order, std::nullopt, FillSink());
+        return;
     }
 
+    // StopLimit: becomes a limit order, keeping its id and handle
+    order.type = OrderType::Limit;
+    Tick tick = order.price;
+    int remainingQty = (order.agentId >= 0) ? sweep(order, tick, FillSink()).remaining : order.quantity;
+    if (remainingQty == 0) {
+        idLookup.erase(order.id);
+        pool.release(index);
+        return;
+    }
+    order.quantity = remainingQty;
+    pool[index].order = order;
+    pool[index].tick = tick;
+    link(index);
+}
+
+template <typename Config>
+bool BasicOrderBook<Config>::canFill(const Order& order, Tick limit) const {
+    return withSide(order.side, [&]<typename Side>(Side) { return canFill<Side>(order, limit); });
+}
+
+template <typename Config>
+template <typename Side>
+bool BasicOrderBook<Config>::canFill(const Order& order, Tick limit) const {
+    const auto& book = Side::opposite(bids, asks);
+    const auto& owners = Side::opposite(bidOwners, askOwners);
+    bool passOwn = (selfTradePolicy == SelfTradePolicy::Skip || selfTradePolicy == SelfTradePolicy::CancelResting);
+
+    std::int64_t needed = order.quantity;
+    for (auto tick = Side::best(book); tick && Side::reaches(*tick, limit); tick = Side::next(book, *tick)) {
+        OwnedQuantity own = owners.find(order.agentId, *tick);
+        // Orders behind the sender's own may be out of reach under this policy
+        if (own.orders > 0 && !passOwn) return false;
+        needed -= book.find(*tick)->totalQuantity - own.quantity;
+        if (needed <= 0) return true;
+    }
     return false;
 }
 
-std::vector<Fill> OrderBook::matchMarketOrder(const Order& marketOrder) {
+template <typename Config>
+bool BasicOrderBook<Config>::cancelOrder(int orderId) {
+    OrderIndex index = idLookup.find(orderId);
+    if (index == kNullOrder) {
+        if (journal) journal->recordCancel(orderId, -1, 0, true, false);
+        return false;
+    }
+    return cancelOrder(pool.handleOf(index));
+}
+
+template <typename Config>
+bool BasicOrderBook<Config>::cancelOrder(OrderHandle handle) {
+    if (!pool.isLive(handle)) return false;
+    return reduceOrder(handle, pool[handle.slot].order.quantity);
+}
+
+template <typename Config>
+bool BasicOrderBook<Config>::reduceOrder(OrderHandle handle, int quantity) {
+    if (!pool.isLive(handle) || quantity <= 0) return false;
+
+    auto& node = pool[handle.slot];
+    Order& order = node.order;
+    int total = order.quantity + node.reserve;
+    quantity = std::min(quantity, total);
+    ABMS_COUNT(++stats.cancels);
+    if (journal) journal->recordCancel(order.id, order.agentId, quantity, quantity == total, true);
+
+    // Mark the agent as having taken action
+    actionTakenByAgentId = order.agentId;
+
+    if (isParked(order)) {
+        order.quantity -= quantity;
+        if (order.quantity == 0) unpark(handle.slot);
+        return true;
+    }
+
+    // Hidden reserve goes first, so the displayed slice keeps its place
+    int hidden = std::min(quantity, node.reserve);
+    node.reserve -= hidden;
+    ledger.release(order.agentId, order.side, hidden, node.tick);
+    quantity -= hidden;
+    if (quantity > 0) takeQuantity(handle.slot, quantity);
+    return true;
+}
+
+template <typename Config>
+bool BasicOrderBook<Config>::executeOrder(OrderHandle handle, int quantity, long timestamp) {
+    if (!pool.isLive(handle) || quantity <= 0 || isParked(pool[handle.slot].order)) return false;
+
+    Order& order = pool[handle.slot].order;
+    quantity = std::min(quantity, order.quantity);
+    ABMS_COUNT(++stats.fills);
+    if (journal) journal->recordExecute(order, quantity, timestamp);
+
+    lastTradeTick = order.price;
+    publish(Fill{
+        .agentId = order.agentId,
+        .quantity = quantity,
+        .price = order.price,
+        .side = order.side,
+        .moneyPerTick = kMoneyPerTick,
+        .timestamp = timestamp
+    });
+
+    takeQuantity(handle.slot, quantity);
+    fireStops(timestamp);
+    return true;
+}
+
+template <typename Config>
+const Order* BasicOrderBook<Config>::findOrder(OrderHandle handle) const {
+    if (!pool.isLive(handle)) return nullptr;
+    return &pool[handle.slot].order;
+}
+
+template <typename Config>
+std::vector<Fill> BasicOrderBook<Config>::matchMarketOrder(const Order& marketOrder) {
     std::vector<Fill> fills;
-    if (marketOrder.quantity <= 0 || marketOrder.agentId < 0) return fills;
-    
+    matchMarketOrder(marketOrder, FillSink(fills));
+    return fills;
+}
+
+template <typename Config>
+int BasicOrderBook<Config>::matchMarketOrder(const Order& marketOrder, FillSink executions) {
+    if (journal) journal->recordOrder(journal::RecordType::Market, marketOrder);
+    if (marketOrder.quantity <= 0 || marketOrder.agentId < 0) return 0;
+
+    ABMS_COUNT(++stats.ordersPlaced);
     actionTakenByAgentId = marketOrder.agentId;
-    int remainingQty = marketOrder.quantity;
-    auto& book = (marketOrder.side == OrderSide::BUY) ? asks : bids;
-
-    if (book.empty()) return fills;
-
-    while (remainingQty > 0 && !book.empty()) {
-        auto priceIt = (marketOrder.side == OrderSide::BUY) ? 
-                      book.begin() : std::prev(book.end());
-        auto& orderQueue = priceIt->second;
-        
-        // Use an iterator to track our position in the queue
-        auto orderIt = orderQueue.begin();
-        
-        while (orderIt != orderQueue.end() && remainingQty > 0) {
-            Order& passiveOrder = *orderIt;
-            
-            // Skip self-trades but preserve the order for other agents
-            if (passiveOrder.agentId == marketOrder.agentId) {
-                // Using iterator to skip without modifying queue structure
-                // This preserves FIFO order priority while preventing self-trading
-                ++orderIt;
+    int filled = sweep(marketOrder, std::nullopt, executions).filled;
+    fireStops(marketOrder.timestamp);
+    return filled;
+}
+
+template <typename Config>
+void BasicOrderBook<Config>::submitBatch(std::span<const Order> orders, FillSink fills) {
+    batchFills = &fills;
+    for (const Order& order : orders) {
+        if (order.type == OrderType::Market) {
+            ABMS_PROFILE_SAMPLED(Phase::MarketMatching);
+            matchMarketOrder(order, FillSink());
+        } else {
+            ABMS_PROFILE_SAMPLED(Phase::LimitPlacement);
+            submitOrder(order, OrderParams{}, FillSink());
+        }
+    }
+    batchFills = nullptr;
+}
+
+template <typename Config>
+void BasicOrderBook<Config>::setSelfTradePolicy(SelfTradePolicy policy) {
+    selfTradePolicy = policy;
+    if (journal) journal->recordSelfTradePolicy(policy);
+}
+
+template <typename Config>
+void BasicOrderBook<Config>::setJournal(OrderJournal* journal) {
+    this->journal = journal;
+    if (journal) journal->recordSelfTradePolicy(selfTradePolicy);
+}
+
+template <typename Config>
+auto BasicOrderBook<Config>::sweep(const Order& aggressor, std::optional<Tick> limit, FillSink executions)
+    -> SweepResult {
+    return withSide(aggressor.side, [&]<typename Side>(Side) {
+        return sweep<Side>(aggressor, limit.value_or(Side::kNoLimit), executions);
+    });
+}
+
+template <typename Config>
+template <typename Side>
+auto BasicOrderBook<Config>::sweep(const Order& aggressor, Tick limit, FillSink executions) -> SweepResult {
+    using Resting = typename Side::Opposite;
+    int remainingQty = aggressor.quantity;
+    int filled = 0;
+    auto& book = Side::opposite(bids, asks);
+    const auto& owners = Side::opposite(bidOwners, askOwners);
+    bool skipOwn = (selfTradePolicy == SelfTradePolicy::Skip);
+
+    for (auto best = Side::best(book); best && remainingQty > 0; best = Side::next(book, *best)) {
+        if (!Side::reaches(*best, limit)) break;
+
+        auto& level = *book.find(*best);
+        ABMS_COUNT(++stats.levelsTouched);
+
+        // The aggressor's own orders here, and everyone else's quantity.
+        // Under Skip a level that is all its own is passed without a scan,
+        // and a scan stops once the other agents' quantity is used up.
+        OwnedQuantity own = owners.find(aggressor.agentId, *best);
+        Quantity others = level.totalQuantity - own.quantity;
+        std::uint32_t ownLeft = own.orders;
+        if (skipOwn && others == 0) {
+            ABMS_COUNT(stats.selfTrades += ownLeft);
+            continue;
+        }
+
+        OrderIndex index = level.queue.head;
+        while (index != kNullOrder && remainingQty > 0) {
+            Order& passiveOrder = pool[index].order;
+            OrderIndex next = pool[index].next;
+
+            if (ownLeft > 0 && passiveOrder.agentId == aggressor.agentId) {
+                ABMS_COUNT(++stats.selfTrades);
+                --ownLeft;
+                switch (selfTradePolicy) {
+                case SelfTradePolicy::Skip:
+                    break;
+                case SelfTradePolicy::CancelResting: {
+                    // All of it, hidden iceberg reserve included
+                    auto& node = pool[index];
+                    ledger.release(passiveOrder.agentId, passiveOrder.side, node.reserve, node.tick);
+                    node.reserve = 0;
+                    takeQuantity<Resting>(index, level, passiveOrder.quantity);
+                    break;
+                }
+                case SelfTradePolicy::CancelAggressor:
+                    remainingQty = 0;
+                    break;
+                case SelfTradePolicy::DecrementBoth: {
+                    int decrement = std::min(remainingQty, passiveOrder.quantity);
+                    remainingQty -= decrement;
+                    // A refilled iceberg slice is still the aggressor's, now at the
+                    // back of the queue; if it was last, it is next
+                    if (takeQuantity<Resting>(index, level, decrement)) {
+                        ++ownLeft;
+                        if (next == kNullOrder) next = index;
+                    }
+                    break;
+                }
+                }
+                index = next;
                 continue;
             }
 
             int fillQty = std::min(remainingQty, passiveOrder.quantity);
+            ABMS_COUNT(++stats.fills);
+            if (journal) journal->recordTrade(passiveOrder, fillQty, aggressor.timestamp);
 
             // Update last trade price
-            lastTradePrice = passiveOrder.price;
+            lastTradeTick = passiveOrder.price;
 
             // Passive order fill (agent who placed the limit order)
-            recentFills.emplace_back(Fill{
+            publish(Fill{
                 .agentId = passiveOrder.agentId,
-                .price = passiveOrder.price,
                 .quantity = fillQty,
+                .price = passiveOrder.price,
                 .side = passiveOrder.side,
-                .timestamp = marketOrder.timestamp,
-                .isReservation = false
+                .moneyPerTick = kMoneyPerTick,
+                .timestamp = aggressor.timestamp
             });
 
-            // Active order fill (agent who placed the market order)
-            fills.emplace_back(Fill{
-                .agentId = marketOrder.agentId,
-                .price = passiveOrder.price,
+            // Active order fill (agent who sent the aggressing order)
+            const Fill active{
+                .agentId = aggressor.agentId,
                 .quantity = fillQty,
-                .side = marketOrder.side,
-                .timestamp = marketOrder.timestamp,
-                .isReservation = false
-            });
+                .price = passiveOrder.price,
+                .side = aggressor.side,
+                .isAggressor = true,
+                .moneyPerTick = kMoneyPerTick,
+                .timestamp = aggressor.timestamp
+            };
+            publish(active);
+            executions(active);
 
-            // Update quantities
             remainingQty -= fillQty;
-            passiveOrder.quantity -= fillQty;
-
-            // Remove filled passive orders
-            if (passiveOrder.quantity == 0) {
-                idLookup.erase(passiveOrder.id);
-                orderIt = orderQueue.erase(orderIt);
-            } else {
-                ++orderIt;
+            filled += fillQty;
+            // A refilled iceberg slice moves to the back; if it was last, it is next
+            if (takeQuantity<Resting>(index, level, fillQty) && next == kNullOrder) next = index;
+            others = level.totalQuantity - own.quantity;
+            if (skipOwn && others == 0) {
+                // Only the aggressor's own orders are left at this level
+                ABMS_COUNT(stats.selfTrades += ownLeft);
+                break;
             }
+            index = next;
         }
 
         // Remove empty price levels
-        if (orderQueue.empty()) {
-            book.erase(priceIt);
-        } else if (remainingQty > 0) {
-            // No more matchable orders at this price level
-            break;
-        }
+        if (level.queue.empty()) book.release(*best);
     }
 
-    return fills;
+    return {filled, remainingQty};
 }
 
-std::optional<double> OrderBook::bestBid() const {
-    if (bids.empty()) return std::nullopt;
-    return bids.rbegin()->first;
+template <typename Config>
+std::optional<double> BasicOrderBook<Config>::bestBid() const {
+    auto tick = bids.highest();
+    if (!tick) return std::nullopt;
+    return toPrice(*tick);
 }
 
-std::optional<double> OrderBook::bestAsk() const {
-    if (asks.empty()) return std::nullopt;
-    return asks.begin()->first;
+template <typename Config>
+std::optional<double> BasicOrderBook<Config>::bestAsk() const {
+    auto tick = asks.lowest();
+    if (!tick) return std::nullopt;
+    return toPrice(*tick);
+}
+
+template <typename Config>
+std::pair<std::size_t, std::size_t> BasicOrderBook<Config>::depthSnapshot(std::span<DepthLevel> bidOut,
+                                                             std::span<DepthLevel> askOut) const {
+    auto copySide = [](const Ladder& ladder, std::span<DepthLevel> out, bool descending) {
+        std::size_t n = 0;
+        auto tick = descending ? ladder.highest() : ladder.lowest();
+        for (; tick && n < out.size(); tick = descending ? ladder.nextLower(*tick) : ladder.nextHigher(*tick)) {
+            const auto& level = *ladder.find(*tick);
+            out[n++] = DepthLevel{toPrice(*tick), level.totalQuantity, level.orderCount};
+        }
+        return n;
+    };
+    return {copySide(bids, bidOut, true), copySide(asks, askOut, false)};
 }
 
-void OrderBook::printBook() const {
+template <typename Config>
+void BasicOrderBook<Config>::printBook() const {
     std::cout << "=== ORDER BOOK ===\n";
-    
-    // Print asks from highest to lowest
-    std::cout << "Asks (Sell Orders):\n";
-    if (asks.empty()) {
-        std::cout << "  [empty]\n";
-    } else {
-        for (auto it = asks.rbegin(); it != asks.rend(); ++it) {
-            int totalQty = 0;
-            for (const auto& order : it->second) {
-                totalQty += order.quantity;
-            }
-            std::cout << "  Price: " << std::fixed << std::setprecision(2) << it->first 
-                      << " | Qty: " << totalQty << "\n";
+
+    auto printSide = [](const Ladder& ladder) {
+        if (ladder.empty()) {
+            std::cout << "  [empty]\n";
+            return;
         }
-    }
-    
-    // Print bids from highest to lowest
+        // Highest to lowest
+        for (auto tick = ladder.highest(); tick; tick = ladder.nextLower(*tick)) {
+            const auto& level = *ladder.find(*tick);
+            std::cout << "  Price: " << std::fixed << std::setprecision(2) << toPrice(*tick)
+                      << " | Qty: " << level.totalQuantity
+                      << " | Orders: " << level.orderCount << "\n";
+        }
+    };
+
+    std::cout << "Asks (Sell Orders):\n";
+    printSide(asks);
     std::cout << "Bids (Buy Orders):\n";
-    if (bids.empty()) {
-        std::cout << "  [empty]\n";
-    } else {
-        for (auto it = bids.rbegin(); it != bids.rend(); ++it) {
-            int totalQty = 0;
-            for (const auto& order : it->second) {
-                totalQty += order.quantity;
-            }
-            std::cout << "  Price: " << std::fixed << std::setprecision(2) << it->first 
-                      << " | Qty: " << totalQty << "\n";
+    printSide(bids);
+}
+
+template <typename Config>
+std::map<double, std::deque<Order>> BasicOrderBook<Config>::toMap(const Ladder& ladder) const {
+    std::map<double, std::deque<Order>> out;
+    for (auto tick = ladder.lowest(); tick; tick = ladder.nextHigher(*tick)) {
+        auto& orders = out[toPrice(*tick)];
+        for (OrderIndex i = ladder.find(*tick)->queue.head; i != kNullOrder; i = pool[i].next) {
+            orders.push_back(pool[i].order);
         }
     }
+    return out;
 }
 
-const std::vector<Fill>& OrderBook::getRecentFills() const {
+template <typename Config>
+const std::vector<Fill>& BasicOrderBook<Config>::getRecentFills() const {
     return recentFills;
 }
 
-void OrderBook::clearFills() {
+template <typename Config>
+void BasicOrderBook<Config>::clearFills() {
     recentFills.clear();
 }
 
-double OrderBook::getMidPrice() const {
+template <typename Config>
+double BasicOrderBook<Config>::getMidPrice() const {
     auto bid = bestBid();
     auto ask = bestAsk();
-    
+
     if (bid && ask) {
         // If we have both sides, use the midpoint
         return (bid.value() + ask.value()) / 2.0;
@@ -249,19 +599,111 @@ double OrderBook::getMidPrice() const {
         return ask.value();
     } else {
         // When no orders exist, use the last trade price
-        return lastTradePrice;
+        return getLastTradePrice();
     }
 }
 
-double OrderBook::getLastTradePrice() const {
-    return lastTradePrice;
+template <typename Config>
+double BasicOrderBook<Config>::getLastTradePrice() const {
+    return toPrice(lastTradeTick);
 }
 
-bool OrderBook::wasActionTakenByAgent(int agentId) const {
+template <typename Config>
+bool BasicOrderBook<Config>::wasActionTakenByAgent(int agentId) const {
     return actionTakenByAgentId == agentId;
 }
 
-void OrderBook::clearAgentActionFlag() {
+template <typename Config>
+void BasicOrderBook<Config>::clearAgentActionFlag() {
     actionTakenByAgentId = -1;
 }
 
+template <typename Config>
+void BasicOrderBook<Config>::saveState(BinaryWriter& out) const {
+    out.write<std::int32_t>(nextOrderId);
+    out.write<Tick>(lastTradeTick);
+    out.write<std::int32_t>(actionTakenByAgentId);
+    out.write(stats);
+
+    auto saveOrder = [&](OrderIndex i) {
+        const Order& order = pool[i].order;
+        out.write<Tick>(pool[i].tick);
+        out.write<std::int32_t>(order.id);
+        out.write<std::int32_t>(order.agentId);
+        out.write<Tick>(order.price);
+        out.write<std::int32_t>(order.quantity);
+        out.write<std::int64_t>(order.timestamp);
+        out.write<std::uint8_t>(static_cast<std::uint8_t>(order.type));
+        out.write<std::int32_t>(pool[i].display);
+        out.write<std::int32_t>(pool[i].reserve);
+    };
+
+    // Per side: order count, then orders level by level in queue order
+    auto saveSide = [&](const Ladder& ladder) {
+        std::uint64_t count = 0;
+        for (auto tick = ladder.lowest(); tick; tick = ladder.nextHigher(*tick)) {
+            count += ladder.find(*tick)->orderCount;
+        }
+        out.write(count);
+        for (auto tick = ladder.lowest(); tick; tick = ladder.nextHigher(*tick)) {
+            for (OrderIndex i = ladder.find(*tick)->queue.head; i != kNullOrder; i = pool[i].next) {
+                saveOrder(i);
+            }
+        }
+    };
+    saveSide(bids);
+    saveSide(asks);
+
+    // Parked stops in firing order, so parking them again keeps their priority
+    out.write<std::uint64_t>(stops.size());
+    stops.forEach([&](OrderSide side, Tick, OrderIndex i) {
+        out.write<std::uint8_t>(static_cast<std::uint8_t>(side));
+        saveOrder(i);
+    });
+}
+
+template <typename Config>
+void BasicOrderBook<Config>::loadState(BinaryReader& in) {
+    OrderJournal* attached = journal;
+    SelfTradePolicy policy = selfTradePolicy;
+    *this = BasicOrderBook();
+    journal = attached;
+    selfTradePolicy = policy;
+    nextOrderId = in.read<std::int32_t>();
+    lastTradeTick = in.read<Tick>();
+    actionTakenByAgentId = in.read<std::int32_t>();
+    stats = in.read<BookStats>();
+
+    // Returns the order with its node tick (the stop tick if parked), display and hidden reserve
+    auto loadOrder = [&](OrderSide side) {
+        Order order;
+        Tick tick = in.read<Tick>();
+        order.id = in.read<std::int32_t>();
+        order.agentId = in.read<std::int32_t>();
+        order.price = in.read<Tick>();
+        order.quantity = in.read<std::int32_t>();
+        order.side = side;
+        order.timestamp = in.read<std::int64_t>();
+        order.type = static_cast<OrderType>(in.read<std::uint8_t>());
+        int display = in.read<std::int32_t>();
+        int reserve = in.read<std::int32_t>();
+        return std::tuple{order, tick, display, reserve};
+    };
+
+    for (OrderSide side : {OrderSide::BUY, OrderSide::SELL}) {
+        auto count = in.read<std::uint64_t>();
+        for (std::uint64_t n = 0; n < count; ++n) {
+            auto [order, tick, display, reserve] = loadOrder(side);
+            rest(order, reserve, display);
+        }
+    }
+
+    auto stopCount = in.read<std::uint64_t>();
+    for (std::uint64_t n = 0; n < stopCount; ++n) {
+        auto side = static_cast<OrderSide>(in.read<std::uint8_t>());
+        auto [order, tick, display, reserve] = loadOrder(side);
+        park(order, tick);
+    }
+}
+
+template class BasicOrderBook<DefaultBookConfig>;
@@ -0,0 +1,141 @@
+#include "core/OrderGateway.hpp"
+#include "utils/Log.hpp"
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+constexpr std::uint32_t kNoProducer = static_cast<std::uint32_t>(-1);
+// Requests taken from one producer before moving to the next (free-running)
+constexpr int kBurst = 64;
+
+} // namespace
+
+OrderGateway::OrderGateway(OrderBook& book, const GatewayConfig& config)
+    : book(book),
+      config(config) {
+    if (config.producers == 0) {
+        throw std::invalid_argument("Gateway needs at least one producer");
+    }
+    for (std::size_t i = 0; i < config.producers; ++i) {
+        ports.push_back(std::make_unique<Port>(config.ringCapacity));
+    }
+}
+
+OrderGateway::~OrderGateway() {
+    if (matcher.joinable()) stop();
+}
+
+std::uint64_t OrderGateway::nowNanos() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void OrderGateway::route(int agentId, std::size_t producer) {
+    if (agentId < 0 || producer >= ports.size()) {
+        throw std::invalid_argument("Cannot route agent " + std::to_string(agentId));
+    }
+    if (static_cast<std::size_t>(agentId) >= producerById.size()) {
+        producerById.resize(static_cast<std::size_t>(agentId) + 1, kNoProducer);
+    }
+    producerById[agentId] = static_cast<std::uint32_t>(producer);
+}
+
+void OrderGateway::start() {
+    stopping.store(false, std::memory_order_relaxed);
+    matcher = std::thread([this] { matchingLoop(); });
+#if defined(__linux__)
+    if (config.matchingCpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config.matchingCpu, &cpus);
+        if (pthread_setaffinity_np(matcher.native_handle(), sizeof(cpus), &cpus) != 0) {
+            ABMS_LOG(LogLevel::Warn, LogCategory::General,
+                     "Cannot pin the matching thread to CPU " << config.matchingCpu << "\n");
+        }
+    }
+#endif
+}
+
+void OrderGateway::stop() {
+    stopping.store(true, std::memory_order_release);
+    if (matcher.joinable()) matcher.join();
+}
+
+void OrderGateway::matchingLoop() {
+    std::size_t cursor = 0;  // sequenced: producer whose part of the batch is being applied
+    GatewayRequest request;
+
+    for (;;) {
+        // Producers are done before stop(), so a pass that starts after it
+        // and finds nothing means everything has been applied
+        bool finishing = stopping.load(std::memory_order_acquire);
+        bool progressed = false;
+
+        if (config.sequenced) {
+            while (ports[cursor]->requests.tryPop(request)) {
+                progressed = true;
+                if (request.kind == GatewayRequest::Kind::Order) {
+                    apply(request);
+                    continue;
+                }
+                // This producer's part is in; the batch closes after the last one's
+                if (++cursor == ports.size()) {
+                    cursor = 0;
+                    for (std::size_t i = 0; i < ports.size(); ++i) closeBatch(i, request.batch);
+                }
+                break;
+            }
+        } else {
+            for (std::size_t i = 0; i < ports.size(); ++i) {
+                for (int n = 0; n < kBurst && ports[i]->requests.tryPop(request); ++n) {
+                    progressed = true;
+                    if (request.kind == GatewayRequest::Kind::Order) {
+                        apply(request);
+                    } else {
+                        closeBatch(i, request.batch);
+                    }
+                }
+            }
+        }
+
+        if (!progressed) {
+            if (finishing) return;
+            std::this_thread::yield();
+        }
+    }
+}
+
+void OrderGateway::apply(const GatewayRequest& request) {
+    std::uint64_t start = nowNanos();
+    queued.add(start - request.sentNanos);
+    submitIntent(book, request.intent, request.batch);
+    matching.add(nowNanos() - start);
+    ++orders;
+
+    for (const Fill& fill : book.getRecentFills()) {
+        if (!fill.isAggressor) ++trades;
+        if (fill.agentId < 0 || static_cast<std::size_t>(fill.agentId) >= producerById.size()) continue;
+        std::uint32_t producer = producerById[fill.agentId];
+        if (producer != kNoProducer) {
+            send(producer, ExecutionReport{ExecutionReport::Kind::Fill, request.batch, fill, {}});
+        }
+    }
+    book.clearFills();
+}
+
+void OrderGateway::closeBatch(std::size_t producer, long batch) {
+    send(producer, ExecutionReport{ExecutionReport::Kind::EndOfBatch, batch, {}, MarketSnapshot::of(book)});
+}
+
+void OrderGateway::send(std::size_t producer, const ExecutionReport& report) {
+    // The producer drains its reports whenever it waits on us, so this ends
+    while (!ports[producer]->reports.tryPush(report)) {
+        std::this_thread::yield();
+    }
+}
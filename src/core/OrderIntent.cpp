@@ -0,0 +1,75 @@
+#include "core/OrderIntent.hpp"
+#include "core/OrderBook.hpp"
+#include "utils/Log.hpp"
+#include "utils/Profiler.hpp"
+#include <iomanip>
+
+MarketSnapshot MarketSnapshot::of(const OrderBook& book) {
+    return MarketSnapshot{
+        .bestBid = book.bestBid(),
+        .bestAsk = book.bestAsk(),
+        .midPrice = book.getMidPrice(),
+        .lastTradePrice = book.getLastTradePrice()
+    };
+}
+
+std::optional<Order> asOrder(const OrderIntent& intent, long timestamp) {
+    switch (intent.type) {
+    case IntentType::LIMIT:
+        return Order{-1, intent.agentId, OrderBook::limitTick(intent.side, intent.price), intent.quantity,
+                     intent.side, OrderType::Limit, timestamp};
+    case IntentType::MARKET:
+        return Order{-1, intent.agentId, 0, intent.quantity, intent.side, OrderType::Market, timestamp};
+    default:
+        return std::nullopt;
+    }
+}
+
+void submitIntent(OrderBook& book, const OrderIntent& intent, long timestamp, FillSink executions) {
+    switch (intent.type) {
+    case IntentType::LIMIT: {
+        ABMS_PROFILE_SAMPLED(Phase::LimitPlacement);
+        book.addLimitOrder(*asOrder(intent, timestamp), executions);
+        break;
+    }
+    case IntentType::MARKET: {
+        Order order = *asOrder(intent, timestamp);
+        int filled;
+        if (ABMS_LOG_ENABLED(LogLevel::Debug, LogCategory::Fill)) {
+            auto logFill = [&](const Fill& fill) {
+                ABMS_LOG(LogLevel::Debug, LogCategory::Fill,
+                         "  -> Agent " << intent.agentId << " filled " << fill.quantity
+                         << " @ " << std::fixed << std::setprecision(2) << OrderBook::toPrice(fill.price) << "\n");
+                executions(fill);
+            };
+            ABMS_PROFILE_SAMPLED(Phase::MarketMatching);
+            filled = book.matchMarketOrder(order, FillSink(logFill));
+        } else {
+            ABMS_PROFILE_SAMPLED(Phase::MarketMatching);
+            filled = book.matchMarketOrder(order, executions);
+        }
+        if (filled == 0) {
+            ABMS_LOG(LogLevel::Debug, LogCategory::Fill,
+                     "  -> Agent " << intent.agentId << " market order: no fills, insufficient liquidity\n");
+        }
+        break;
+    }
+    case IntentType::CANCEL:
+        book.cancelOrder(intent.orderId);
+        break;
+    case IntentType::ORDER: {
+        ABMS_PROFILE_SAMPLED(Phase::LimitPlacement);
+        Order order{-1, intent.agentId, OrderBook::limitTick(intent.side, intent.price), intent.quantity,
+                    intent.side, intent.orderType, timestamp};
+        OrderParams params{OrderBook::toTicks(intent.stopPrice), intent.displayQuantity};
+        book.submitOrder(order, params, executions);
+        break;
+    }
+    }
+}
+
+void submitIntents(OrderBook& book, std::span<const OrderIntent> intents, long timestamp, FillSink executions) {
+    for (const auto& intent : intents) {
+        submitIntent(book, intent, timestamp, executions);
+    }
+}
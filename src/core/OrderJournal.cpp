@@ -0,0 +1,263 @@
+#include "core/OrderJournal.hpp"
+#include "core/OrderBook.hpp"
+#include <cstring>
+#include <stdexcept>
+
+using journal::Record;
+using journal::RecordType;
+
+OrderJournal::OrderJournal(const std::string& filename, std::size_t bufferRecords)
+    : out(std::fopen(filename.c_str(), "wb")), capacity(bufferRecords == 0 ? 1 : bufferRecords) {
+    if (!out) throw std::runtime_error("Cannot open " + filename + " for writing");
+    buffer.reserve(capacity);
+
+    journal::FileHeader header{};
+    std::memcpy(header.magic, journal::kMagic, sizeof(header.magic));
+    header.version = journal::kVersion;
+    header.recordSize = sizeof(Record);
+    std::fwrite(&header, sizeof(header), 1, out);
+}
+
+OrderJournal::~OrderJournal() {
+    close();
+}
+
+void OrderJournal::recordOrder(RecordType type, const Order& order, const OrderParams& params) {
+    lastTimestamp = order.timestamp;
+    if (order.type == OrderType::Stop || order.type == OrderType::StopLimit || order.type == OrderType::Iceberg) {
+        append(Record{
+            .type = RecordType::Params,
+            .side = static_cast<std::uint8_t>(order.side),
+            .ok = 1,
+            .orderType = static_cast<std::uint8_t>(order.type),
+            .agentId = order.agentId,
+            .timestamp = order.timestamp,
+            .price = params.stopPrice,
+            .orderId = 0,
+            .quantity = params.displayQuantity
+        });
+    }
+    append(Record{
+        .type = type,
+        .side = static_cast<std::uint8_t>(order.side),
+        .ok = 1,
+        .orderType = static_cast<std::uint8_t>(type == RecordType::Market ? OrderType::Market : order.type),
+        .agentId = order.agentId,
+        .timestamp = order.timestamp,
+        .price = type == RecordType::Market ? 0 : order.price,
+        .orderId = order.id,
+        .quantity = order.quantity
+    });
+}
+
+void OrderJournal::recordTrade(const Order& passive, int quantity, long timestamp) {
+    append(Record{
+        .type = RecordType::Trade,
+        .side = static_cast<std::uint8_t>(passive.side),
+        .ok = 1,
+        .orderType = 0,
+        .agentId = passive.agentId,
+        .timestamp = timestamp,
+        .price = passive.price,
+        .orderId = passive.id,
+        .quantity = quantity
+    });
+}
+
+void OrderJournal::recordCancel(int orderId, int agentId, int quantity, bool whole, bool ok) {
+    append(Record{
+        .type = whole ? RecordType::Cancel : RecordType::Reduce,
+        .side = 0,
+        .ok = static_cast<std::uint8_t>(ok),
+        .orderType = 0,
+        .agentId = agentId,
+        .timestamp = lastTimestamp,
+        .price = 0,
+        .orderId = orderId,
+        .quantity = quantity
+    });
+}
+
+void OrderJournal::recordExecute(const Order& order, int quantity, long timestamp) {
+    lastTimestamp = timestamp;
+    append(Record{
+        .type = RecordType::Execute,
+        .side = static_cast<std::uint8_t>(order.side),
+        .ok = 1,
+        .orderType = 0,
+        .agentId = order.agentId,
+        .timestamp = timestamp,
+        .price = order.price,
+        .orderId = order.id,
+        .quantity = quantity
+    });
+}
+
+void OrderJournal::recordSelfTradePolicy(SelfTradePolicy policy) {
+    append(Record{
+        .type = RecordType::SelfTrade,
+        .side = 0,
+        .ok = 1,
+        .orderType = 0,
+        .agentId = -1,
+        .timestamp = lastTimestamp,
+        .price = 0,
+        .orderId = 0,
+        .quantity = static_cast<std::int32_t>(policy)
+    });
+}
+
+void OrderJournal::flush() {
+    if (!out || buffer.empty()) return;
+    std::fwrite(buffer.data(), sizeof(Record), buffer.size(), out);
+    written += buffer.size();
+    buffer.clear();
+}
+
+void OrderJournal::close() {
+    if (!out) return;
+    flush();
+    std::fclose(out);
+    out = nullptr;
+}
+
+namespace {
+
+bool sameTrade(const Record& recorded, const Fill& fill) {
+    return recorded.agentId == fill.agentId
+        && recorded.price == fill.price
+        && recorded.quantity == fill.quantity
+        && recorded.side == static_cast<std::uint8_t>(fill.side)
+        && recorded.timestamp == fill.timestamp;
+}
+
+} // namespace
+
+ReplayResult replayJournal(std::span<const std::byte> data, OrderBook& book, bool verify) {
+    journal::FileHeader header;
+    if (data.size() < sizeof(header)) throw std::runtime_error("Journal is too short");
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, journal::kMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Not an order journal");
+    }
+    if (header.version != journal::kVersion || header.recordSize != sizeof(Record)) {
+        throw std::runtime_error("Unsupported journal version");
+    }
+    const std::byte* records = data.data() + sizeof(header);
+    const std::size_t count = (data.size() - sizeof(header)) / sizeof(Record);
+
+    ReplayResult result;
+    result.records = count;
+    result.firstMismatch = count;
+    auto mismatch = [&](std::size_t i) {
+        if (result.mismatches++ == 0) result.firstMismatch = i;
+    };
+
+    // Handles of resting orders by id, for O(1) cancel and reduce
+    std::vector<OrderHandle> handles;
+    // Passive fills of the last order, waiting to be checked against Trade records
+    std::vector<Fill> produced;
+    std::size_t checked = 0;
+    std::size_t lastOrder = 0;
+    // Params record waiting for its Limit record
+    Record params{};
+    bool hasParams = false;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        Record record;
+        std::memcpy(&record, records + i * sizeof(Record), sizeof(Record));
+
+        if (record.type == RecordType::Trade) {
+            if (!verify) continue;
+            if (checked < produced.size() && sameTrade(record, produced[checked])) {
+                ++checked;
+            } else {
+                mismatch(i);
+            }
+            continue;
+        }
+        // Replayed fills the recording did not have
+        if (verify && checked < produced.size()) mismatch(lastOrder);
+        produced.clear();
+        checked = 0;
+        book.clearFills();
+
+        auto side = static_cast<OrderSide>(record.side);
+        switch (record.type) {
+        case RecordType::Limit: {
+            if (record.orderType > static_cast<std::uint8_t>(OrderType::Iceberg)) {
+                throw std::runtime_error("Corrupt journal record " + std::to_string(i));
+            }
+            Order order{-1, record.agentId, record.price, record.quantity, side,
+                        static_cast<OrderType>(record.orderType), record.timestamp};
+            OrderParams orderParams;
+            if (hasParams) {
+                orderParams = OrderParams{params.price, params.quantity};
+                hasParams = false;
+            }
+            OrderHandle handle = book.submitOrder(order, orderParams);
+            if (handle) {
+                auto id = static_cast<std::size_t>(book.findOrder(handle)->id);
+                if (id >= handles.size()) handles.resize(id + 1 + id / 2);
+                handles[id] = handle;
+            }
+            ++result.orders;
+            break;
+        }
+        case RecordType::Market:
+            book.matchMarketOrder(Order{-1, record.agentId, 0, record.quantity, side, OrderType::Market,
+                                        record.timestamp}, FillSink());
+            ++result.orders;
+            break;
+        case RecordType::Execute: {
+            // The record is the fill itself; only the outcome is checked. The
+            // fills of stops it sets off follow as Trade records.
+            auto id = static_cast<std::size_t>(record.orderId);
+            bool ok = id < handles.size()
+                && book.executeOrder(handles[id], record.quantity, static_cast<long>(record.timestamp));
+            if (verify && !ok) mismatch(i);
+            result.trades += ok;
+            break;
+        }
+        case RecordType::Params:
+            params = record;
+            hasParams = true;
+            continue;
+        case RecordType::SelfTrade:
+            if (record.quantity < 0 || record.quantity > static_cast<std::int32_t>(SelfTradePolicy::DecrementBoth)) {
+                throw std::runtime_error("Corrupt journal record " + std::to_string(i));
+            }
+            book.setSelfTradePolicy(static_cast<SelfTradePolicy>(record.quantity));
+            continue;
+        case RecordType::Cancel:
+        case RecordType::Reduce: {
+            auto id = static_cast<std::size_t>(record.orderId);
+            bool ok;
+            if (record.orderId > 0 && id < handles.size() && handles[id]) {
+                ok = record.type == RecordType::Cancel ? book.cancelOrder(handles[id])
+                                                       : book.reduceOrder(handles[id], record.quantity);
+            } else {
+                ok = book.cancelOrder(record.orderId);
+            }
+            if (verify && ok != (record.ok != 0)) mismatch(i);
+            ++result.cancels;
+            break;
+        }
+        default:
+            throw std::runtime_error("Corrupt journal record " + std::to_string(i));
+        }
+
+        std::span<const Fill> fills = book.getRecentFills();
+        // An execution's own fill comes first and has no Trade record
+        if (record.type == RecordType::Execute && !fills.empty()) fills = fills.subspan(1);
+        for (const Fill& fill : fills) {
+            if (fill.isAggressor) continue;
+            ++result.trades;
+            if (verify) produced.push_back(fill);
+        }
+        lastOrder = i;
+    }
+    if (verify && checked < produced.size()) mismatch(lastOrder);
+    book.clearFills();
+    return result;
+}
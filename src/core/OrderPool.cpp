@@ -0,0 +1,59 @@
+#include "core/OrderPool.hpp"
+
+OrderIndex OrderPool::allocate(const Order& order, Tick tick) {
+    OrderIndex index;
+    if (freeHead != kNullOrder) {
+        index = freeHead;
+        freeHead = nodes[index].next;
+    } else {
+        index = static_cast<OrderIndex>(nodes.size());
+        nodes.push_back(Node{{}, 0, 0, 0, kNullOrder, kNullOrder, 0});
+    }
+
+    Node& node = nodes[index];
+    node.order = order;
+    node.tick = tick;
+    node.reserve = 0;
+    node.display = 0;
+    node.prev = kNullOrder;
+    node.next = kNullOrder;
+    ++live;
+    return index;
+}
+
+void OrderPool::release(OrderIndex index) {
+    Node& node = nodes[index];
+    ++node.generation;  // invalidate outstanding handles
+    node.prev = kNullOrder;
+    node.next = freeHead;
+    freeHead = index;
+    --live;
+}
+
+void OrderPool::pushBack(OrderQueue& queue, OrderIndex index) {
+    Node& node = nodes[index];
+    node.prev = queue.tail;
+    node.next = kNullOrder;
+    if (queue.tail != kNullOrder) {
+        nodes[queue.tail].next = index;
+    } else {
+        queue.head = index;
+    }
+    queue.tail = index;
+}
+
+void OrderPool::unlink(OrderQueue& queue, OrderIndex index) {
+    Node& node = nodes[index];
+    if (node.prev != kNullOrder) {
+        nodes[node.prev].next = node.next;
+    } else {
+        queue.head = node.next;
+    }
+    if (node.next != kNullOrder) {
+        nodes[node.next].prev = node.prev;
+    } else {
+        queue.tail = node.prev;
+    }
+    node.prev = kNullOrder;
+    node.next = kNullOrder;
+}
@@ -0,0 +1,235 @@
+#include "core/PriceLadder.hpp"
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+template <typename Quantity>
+BasicPriceLadder<Quantity>::BasicPriceLadder(Touch touch, Tick centerTick, std::size_t capacity)
+    : touch(touch), occupied(0) {
+    // Keep the capacity a power of two and a whole number of bitmap words
+    std::size_t cap = 64;
+    while (cap < capacity) cap *= 2;
+
+    base = centerTick - static_cast<Tick>(cap / 2);
+    levels.resize(cap);
+    words.assign(cap / 64, 0);
+    summary.assign((words.size() + 63) / 64, 0);
+}
+
+template <typename Quantity>
+bool BasicPriceLadder<Quantity>::inWindow(Tick tick) const {
+    return tick >= base && tick < base + static_cast<Tick>(levels.size());
+}
+
+template <typename Quantity>
+std::optional<Tick> BasicPriceLadder<Quantity>::touchTick() const {
+    return (touch == Touch::Highest) ? highest() : lowest();
+}
+
+template <typename Quantity>
+std::size_t BasicPriceLadder<Quantity>::findNextSet(std::size_t pos) const {
+    if (pos >= levels.size()) return npos;
+
+    std::size_t w = pos >> 6;
+    std::uint64_t bits = words[w] & (~0ULL << (pos & 63));
+    if (bits) return (w << 6) + std::countr_zero(bits);
+
+    // Jump to the next non-empty word through the summary
+    std::size_t nw = w + 1;
+    if (nw >= words.size()) return npos;
+    std::size_t s = nw >> 6;
+    std::uint64_t sbits = summary[s] & (~0ULL << (nw & 63));
+    while (true) {
+        if (sbits) {
+            std::size_t ww = (s << 6) + std::countr_zero(sbits);
+            return (ww << 6) + std::countr_zero(words[ww]);
+        }
+        if (++s >= summary.size()) return npos;
+        sbits = summary[s];
+    }
+}
+
+template <typename Quantity>
+std::size_t BasicPriceLadder<Quantity>::findPrevSet(std::size_t pos) const {
+    if (pos == npos) return npos;
+    pos = std::min(pos, levels.size() - 1);
+
+    std::size_t w = pos >> 6;
+    std::uint64_t bits = words[w] & (~0ULL >> (63 - (pos & 63)));
+    if (bits) return (w << 6) + 63 - std::countl_zero(bits);
+
+    // Jump to the previous non-empty word through the summary
+    if (w == 0) return npos;
+    std::size_t pw = w - 1;
+    std::size_t s = pw >> 6;
+    std::uint64_t sbits = summary[s] & (~0ULL >> (63 - (pw & 63)));
+    while (true) {
+        if (sbits) {
+            std::size_t ww = (s << 6) + 63 - std::countl_zero(sbits);
+            return (ww << 6) + 63 - std::countl_zero(words[ww]);
+        }
+        if (s-- == 0) return npos;
+        sbits = summary[s];
+    }
+}
+
+template <typename Quantity>
+void BasicPriceLadder<Quantity>::setBit(std::size_t pos) {
+    std::size_t w = pos >> 6;
+    if (!words[w]) summary[w >> 6] |= 1ULL << (w & 63);
+    words[w] |= 1ULL << (pos & 63);
+}
+
+template <typename Quantity>
+void BasicPriceLadder<Quantity>::clearBit(std::size_t pos) {
+    std::size_t w = pos >> 6;
+    words[w] &= ~(1ULL << (pos & 63));
+    if (!words[w]) summary[w >> 6] &= ~(1ULL << (w & 63));
+}
+
+template <typename Quantity>
+std::optional<Tick> BasicPriceLadder<Quantity>::lowest() const {
+    std::size_t pos = findNextSet(0);
+    if (overflow.empty()) {
+        if (pos == npos) return std::nullopt;
+        return base + static_cast<Tick>(pos);
+    }
+    Tick far = overflow.begin()->first;
+    return (pos == npos) ? far : std::min(far, base + static_cast<Tick>(pos));
+}
+
+template <typename Quantity>
+std::optional<Tick> BasicPriceLadder<Quantity>::highest() const {
+    std::size_t pos = findPrevSet(levels.size() - 1);
+    if (overflow.empty()) {
+        if (pos == npos) return std::nullopt;
+        return base + static_cast<Tick>(pos);
+    }
+    Tick far = overflow.rbegin()->first;
+    return (pos == npos) ? far : std::max(far, base + static_cast<Tick>(pos));
+}
+
+template <typename Quantity>
+std::optional<Tick> BasicPriceLadder<Quantity>::nextLower(Tick tick) const {
+    std::optional<Tick> next;
+    if (tick > base) {
+        // findPrevSet clamps a tick above the window to its last level
+        std::size_t pos = findPrevSet(static_cast<std::size_t>(tick - base) - 1);
+        if (pos != npos) next = base + static_cast<Tick>(pos);
+    }
+    if (!overflow.empty()) {
+        auto it = overflow.lower_bound(tick);
+        if (it != overflow.begin() && (!next || std::prev(it)->first > *next)) next = std::prev(it)->first;
+    }
+    return next;
+}
+
+template <typename Quantity>
+std::optional<Tick> BasicPriceLadder<Quantity>::nextHigher(Tick tick) const {
+    std::optional<Tick> next;
+    std::size_t from = (tick < base) ? 0 : static_cast<std::size_t>(tick - base) + 1;
+    std::size_t pos = findNextSet(from);
+    if (pos != npos) next = base + static_cast<Tick>(pos);
+    if (!overflow.empty()) {
+        auto it = overflow.upper_bound(tick);
+        if (it != overflow.end() && (!next || it->first < *next)) next = it->first;
+    }
+    return next;
+}
+
+template <typename Quantity>
+typename BasicPriceLadder<Quantity>::Level& BasicPriceLadder<Quantity>::acquire(Tick tick) {
+    if (!inWindow(tick)) {
+        auto touchNow = touchTick();
+        bool newTouch = !touchNow || ((touch == Touch::Highest) ? tick > *touchNow : tick < *touchNow);
+        if (!newTouch) {
+            // Away from the touch: keep it out of the window
+            auto [it, inserted] = overflow.try_emplace(tick);
+            if (inserted) ++occupied;
+            return it->second;
+        }
+        recenter(tick);
+    }
+
+    std::size_t pos = static_cast<std::size_t>(tick - base);
+    if (!(words[pos >> 6] & (1ULL << (pos & 63)))) {
+        setBit(pos);
+        ++occupied;
+    }
+    return levels[pos];
+}
+
+template <typename Quantity>
+void BasicPriceLadder<Quantity>::release(Tick tick) {
+    if (inWindow(tick)) {
+        std::size_t pos = static_cast<std::size_t>(tick - base);
+        if (!(words[pos >> 6] & (1ULL << (pos & 63)))) return;
+        clearBit(pos);
+        --occupied;
+    } else if (overflow.erase(tick)) {
+        --occupied;
+    }
+
+    // With the touch gone the next best level may be in the overflow map;
+    // bring the window to it so matching keeps running on the bitmap
+    if (overflow.empty()) return;
+    if (auto touchNow = touchTick(); touchNow && !inWindow(*touchNow)) recenter(*touchNow);
+}
+
+template <typename Quantity>
+typename BasicPriceLadder<Quantity>::Level* BasicPriceLadder<Quantity>::find(Tick tick) {
+    if (!inWindow(tick)) {
+        auto it = overflow.find(tick);
+        return (it == overflow.end()) ? nullptr : &it->second;
+    }
+    std::size_t pos = static_cast<std::size_t>(tick - base);
+    if (!(words[pos >> 6] & (1ULL << (pos & 63)))) return nullptr;
+    return &levels[pos];
+}
+
+template <typename Quantity>
+const typename BasicPriceLadder<Quantity>::Level* BasicPriceLadder<Quantity>::find(Tick tick) const {
+    return const_cast<BasicPriceLadder*>(this)->find(tick);
+}
+
+template <typename Quantity>
+void BasicPriceLadder<Quantity>::recenter(Tick center) {
+    // The window keeps its size: levels that fall outside it move to the
+    // overflow map and overflow levels it now covers move in
+    std::size_t cap = levels.size();
+    Tick newBase = center - static_cast<Tick>(cap / 2);
+    Tick newEnd = newBase + static_cast<Tick>(cap);
+
+    std::vector<Level> newLevels(cap);
+    std::vector<std::uint64_t> oldWords(words.size(), 0);
+    oldWords.swap(words);
+    std::fill(summary.begin(), summary.end(), 0);
+
+    for (std::size_t w = 0; w < oldWords.size(); ++w) {
+        std::uint64_t bits = oldWords[w];
+        while (bits) {
+            std::size_t pos = (w << 6) + std::countr_zero(bits);
+            bits &= bits - 1;
+            Tick t = base + static_cast<Tick>(pos);
+            if (t >= newBase && t < newEnd) {
+                std::size_t newPos = static_cast<std::size_t>(t - newBase);
+                newLevels[newPos] = std::move(levels[pos]);
+                setBit(newPos);
+            } else {
+                overflow.emplace(t, std::move(levels[pos]));
+            }
+        }
+    }
+    for (auto it = overflow.lower_bound(newBase); it != overflow.end() && it->first < newEnd;
+         it = overflow.erase(it)) {
+        std::size_t newPos = static_cast<std::size_t>(it->first - newBase);
+        newLevels[newPos] = std::move(it->second);
+        setBit(newPos);
+    }
+
+    base = newBase;
+    levels.swap(newLevels);
+}
+
+// Depth types used by the book configurations in BookPolicies.hpp
+template class BasicPriceLadder<std::int64_t>;
@@ -0,0 +1,35 @@
+#include "core/TriggerBook.hpp"
+
+void TriggerBook::add(OrderSide side, Tick trigger, OrderIndex index) {
+    // Equal keys go after the existing ones, which keeps FIFO within a tick
+    if (side == OrderSide::BUY) {
+        buys.emplace(trigger, index);
+    } else {
+        sells.emplace(trigger, index);
+    }
+}
+
+bool TriggerBook::remove(OrderSide side, Tick trigger, OrderIndex index) {
+    auto erase = [&](auto& stops) {
+        auto [first, last] = stops.equal_range(trigger);
+        for (auto it = first; it != last; ++it) {
+            if (it->second == index) {
+                stops.erase(it);
+                return true;
+            }
+        }
+        return false;
+    };
+    return side == OrderSide::BUY ? erase(buys) : erase(sells);
+}
+
+void TriggerBook::collect(Tick last, std::vector<OrderIndex>& out) {
+    // Both maps are ordered nearest-to-fire first, so the fired stops are a prefix
+    auto take = [&](auto& stops) {
+        auto end = stops.upper_bound(last);
+        for (auto it = stops.begin(); it != end; ++it) out.push_back(it->second);
+        stops.erase(stops.begin(), end);
+    };
+    take(buys);
+    take(sells);
+}
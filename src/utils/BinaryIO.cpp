@@ -0,0 +1,10 @@
+#include "utils/BinaryIO.hpp"
+#include <cstdio>
+
+void BinaryWriter::saveTo(const std::string& path) const {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) throw std::runtime_error("Cannot open " + path + " for writing");
+    std::size_t written = std::fwrite(buffer.data(), 1, buffer.size(), out);
+    bool ok = (std::fclose(out) == 0) && written == buffer.size();
+    if (!ok) throw std::runtime_error("Cannot write " + path);
+}
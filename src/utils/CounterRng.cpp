@@ -0,0 +1,101 @@
+#include "utils/CounterRng.hpp"
+#include "utils/Seed.hpp"
+
+namespace philox {
+
+Key deriveKey(std::uint64_t masterSeed, std::uint64_t agentId) {
+    std::uint64_t mixed = deriveSeed(masterSeed, agentId);
+    return Key{static_cast<std::uint32_t>(mixed), static_cast<std::uint32_t>(mixed >> 32)};
+}
+
+namespace {
+
+// kLanes independent Philox4x32-10 blocks, word by word
+struct Lanes {
+    std::uint32_t ctr[4][kLanes];
+    std::uint32_t key[2][kLanes];
+};
+
+void philox4x32(Lanes& s) {
+    for (int round = 0; round < 10; ++round) {
+        for (std::size_t l = 0; l < kLanes; ++l) {
+            std::uint64_t p0 = static_cast<std::uint64_t>(kMul0) * s.ctr[0][l];
+            std::uint64_t p1 = static_cast<std::uint64_t>(kMul1) * s.ctr[2][l];
+            std::uint32_t c1 = s.ctr[1][l];
+            std::uint32_t c3 = s.ctr[3][l];
+            s.ctr[0][l] = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ s.key[0][l];
+            s.ctr[1][l] = static_cast<std::uint32_t>(p1);
+            s.ctr[2][l] = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ s.key[1][l];
+            s.ctr[3][l] = static_cast<std::uint32_t>(p0);
+            s.key[0][l] += kWeyl0;
+            s.key[1][l] += kWeyl1;
+        }
+    }
+}
+
+// Lanes for blocks first, first + 1, ... of one stream
+void streamLanes(Lanes& s, const Key& key, std::uint64_t step, std::uint32_t substream, std::uint32_t first) {
+    for (std::size_t l = 0; l < kLanes; ++l) {
+        s.ctr[0][l] = first + static_cast<std::uint32_t>(l);
+        s.ctr[1][l] = static_cast<std::uint32_t>(step);
+        s.ctr[2][l] = static_cast<std::uint32_t>(step >> 32);
+        s.ctr[3][l] = substream;
+        s.key[0][l] = key[0];
+        s.key[1][l] = key[1];
+    }
+    philox4x32(s);
+}
+
+} // namespace
+
+void generateBlocks(std::span<const Key> keys, std::uint64_t step, std::uint32_t substream,
+                    std::uint32_t block, std::span<Block> out) {
+    const std::size_t n = keys.size() < out.size() ? keys.size() : out.size();
+    Lanes s;
+    for (std::size_t i = 0; i < n; i += kLanes) {
+        std::size_t lanes = n - i < kLanes ? n - i : kLanes;
+        for (std::size_t l = 0; l < kLanes; ++l) {
+            const Key& key = keys[i + (l < lanes ? l : 0)];
+            s.ctr[0][l] = block;
+            s.ctr[1][l] = static_cast<std::uint32_t>(step);
+            s.ctr[2][l] = static_cast<std::uint32_t>(step >> 32);
+            s.ctr[3][l] = substream;
+            s.key[0][l] = key[0];
+            s.key[1][l] = key[1];
+        }
+        philox4x32(s);
+        for (std::size_t l = 0; l < lanes; ++l) {
+            out[i + l] = Block{s.ctr[0][l], s.ctr[1][l], s.ctr[2][l], s.ctr[3][l]};
+        }
+    }
+}
+
+void uniformBatch(const Key& key, std::uint64_t step, std::uint32_t substream, std::span<double> out) {
+    // Two doubles per block
+    Lanes s;
+    std::uint32_t block = 0;
+    for (std::size_t i = 0; i < out.size(); block += kLanes) {
+        streamLanes(s, key, step, substream, block);
+        for (std::size_t l = 0; l < kLanes && i < out.size(); ++l) {
+            out[i++] = toUnit(s.ctr[0][l], s.ctr[1][l]);
+            if (i < out.size()) out[i++] = toUnit(s.ctr[2][l], s.ctr[3][l]);
+        }
+    }
+}
+
+void uniformIntBatch(const Key& key, std::uint64_t step, std::uint32_t substream,
+                     int lo, int hi, std::span<int> out) {
+    Lanes s;
+    std::uint32_t block = 0;
+    for (std::size_t i = 0; i < out.size(); block += kLanes) {
+        streamLanes(s, key, step, substream, block);
+        for (std::size_t l = 0; l < kLanes; ++l) {
+            for (int w = 0; w < 4 && i < out.size(); ++w) out[i++] = toRange(s.ctr[w][l], lo, hi);
+        }
+    }
+}
+
+} // namespace philox
+
+AgentRng::AgentRng(std::uint64_t masterSeed, std::uint64_t agentId)
+    : key(philox::deriveKey(masterSeed, agentId)) {}
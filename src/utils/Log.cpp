@@ -0,0 +1,39 @@
+#include "utils/Log.hpp"
+#include <atomic>
+#include <iostream>
+
+namespace {
+
+std::atomic<int> currentLevel{static_cast<int>(LogLevel::Trace)};
+std::atomic<std::uint32_t> categoryMask{static_cast<std::uint32_t>(LogCategory::All)};
+
+} // namespace
+
+namespace logging {
+
+void setLevel(LogLevel level) {
+    currentLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel level() {
+    return static_cast<LogLevel>(currentLevel.load(std::memory_order_relaxed));
+}
+
+void setCategories(std::uint32_t mask) {
+    categoryMask.store(mask, std::memory_order_relaxed);
+}
+
+std::uint32_t categories() {
+    return categoryMask.load(std::memory_order_relaxed);
+}
+
+bool enabled(LogLevel level, LogCategory category) {
+    return static_cast<int>(level) <= currentLevel.load(std::memory_order_relaxed)
+        && (categoryMask.load(std::memory_order_relaxed) & static_cast<std::uint32_t>(category)) != 0;
+}
+
+std::ostream& stream(LogLevel level) {
+    return (level <= LogLevel::Warn) ? std::cerr : std::cout;
+}
+
+} // namespace logging
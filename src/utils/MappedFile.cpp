@@ -0,0 +1,50 @@
+#include "utils/MappedFile.hpp"
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ABMS_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef ABMS_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + path);
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat " + path);
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    if (size > 0) {
+        void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            data = static_cast<const std::byte*>(address);
+            mapped = true;
+        }
+    }
+    ::close(fd);
+    if (mapped || size == 0) return;
+#endif
+
+    // No mmap (or it failed): read the file instead
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) throw std::runtime_error("Cannot open " + path);
+    fallback.resize(static_cast<std::size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(fallback.data()), static_cast<std::streamsize>(fallback.size()));
+    if (!in) throw std::runtime_error("Cannot read " + path);
+    data = fallback.data();
+    size = fallback.size();
+}
+
+MappedFile::~MappedFile() {
+#ifdef ABMS_HAVE_MMAP
+    if (mapped) ::munmap(const_cast<std::byte*>(data), size);
+#endif
+}
@@ -0,0 +1,128 @@
+#include "utils/Profiler.hpp"
+#include <bit>
+#include <iomanip>
+
+int LatencyHistogram::bucketOf(std::uint64_t ns) {
+    if (ns < 16) return static_cast<int>(ns);
+    int exponent = 63 - std::countl_zero(ns);  // >= 4
+    int sub = static_cast<int>((ns >> (exponent - 3)) & (kSubBuckets - 1));
+    return 16 + (exponent - 4) * kSubBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::bucketFloor(int bucket) {
+    if (bucket < 16) return static_cast<std::uint64_t>(bucket);
+    int exponent = (bucket - 16) / kSubBuckets + 4;
+    int sub = (bucket - 16) % kSubBuckets;
+    return (std::uint64_t{1} << exponent) + (static_cast<std::uint64_t>(sub) << (exponent - 3));
+}
+
+void LatencyHistogram::add(std::uint64_t ns) {
+    ++counts[bucketOf(ns)];
+    ++total;
+    if (ns > maxValue) maxValue = ns;
+}
+
+std::uint64_t LatencyHistogram::quantile(double q) const {
+    if (total == 0) return 0;
+    auto target = static_cast<std::uint64_t>(q * static_cast<double>(total));
+    if (target >= total) target = total - 1;
+
+    std::uint64_t seen = 0;
+    for (int b = 0; b < kBuckets; ++b) {
+        seen += counts[b];
+        if (seen > target) return bucketFloor(b);
+    }
+    return maxValue;
+}
+
+void Profiler::endStep() {
+    if (!enabled) return;
+    if (timing) {
+        for (int p = 0; p < kPhases; ++p) {
+            // Phases that never ran this step are not recorded as zero samples
+            if (stepTotals[p] > 0 || p == static_cast<int>(Phase::Step)) histograms[p].add(stepTotals[p]);
+            stepTotals[p] = 0;
+        }
+    }
+    timing = (++stepCount % kStepSampleEvery == 0);
+}
+
+void Profiler::setCounter(const std::string& name, std::uint64_t value) {
+    for (auto& counter : counters) {
+        if (counter.first == name) {
+            counter.second = value;
+            return;
+        }
+    }
+    counters.emplace_back(name, value);
+}
+
+const char* Profiler::phaseName(Phase phase) {
+    switch (phase) {
+    case Phase::Step: return "step";
+    case Phase::AgentAct: return "agent_act";
+    case Phase::LimitPlacement: return "limit_placement";
+    case Phase::MarketMatching: return "market_matching";
+    case Phase::FillDispatch: return "fill_dispatch";
+    case Phase::PnLValuation: return "pnl_valuation";
+    case Phase::Recording: return "recording";
+    case Phase::BookPrint: return "book_print";
+    case Phase::Count: break;
+    }
+    return "unknown";
+}
+
+void Profiler::printSummary(std::ostream& out) const {
+    out << "=== PROFILE (ns; per-step time per phase, 1 step in " << kStepSampleEvery
+        << " timed; * per call, 1 call in " << kCallSampleEvery << " timed) ===\n";
+    out << std::left << std::setw(18) << "phase" << std::right
+        << std::setw(10) << "samples" << std::setw(12) << "calls"
+        << std::setw(12) << "p50" << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+    for (int p = 0; p < kPhases; ++p) {
+        const LatencyHistogram& h = histograms[p];
+        if (h.count() == 0) continue;
+        std::string name = phaseName(static_cast<Phase>(p));
+        if (perCall[p]) name += '*';
+        out << std::left << std::setw(18) << name << std::right
+            << std::setw(10) << h.count() << std::setw(12) << calls[p]
+            << std::setw(12) << h.quantile(0.50) << std::setw(12) << h.quantile(0.99)
+            << std::setw(12) << h.max() << "\n";
+    }
+    for (const auto& [name, value] : counters) {
+        out << std::left << std::setw(18) << name << std::right << std::setw(10) << value << "\n";
+    }
+}
+
+void Profiler::writeJson(std::ostream& out) const {
+    out << "{\n  \"phases\": [\n";
+    bool first = true;
+    for (int p = 0; p < kPhases; ++p) {
+        const LatencyHistogram& h = histograms[p];
+        if (h.count() == 0) continue;
+        out << (first ? "" : ",\n")
+            << "    {\"name\": \"" << phaseName(static_cast<Phase>(p)) << "\""
+            << ", \"per\": \"" << (perCall[p] ? "call" : "step") << "\""
+            << ", \"samples\": " << h.count()
+            << ", \"calls\": " << calls[p]
+            << ", \"p50_ns\": " << h.quantile(0.50)
+            << ", \"p99_ns\": " << h.quantile(0.99)
+            << ", \"max_ns\": " << h.max() << "}";
+        first = false;
+    }
+    out << "\n  ],\n  \"counters\": {";
+    first = true;
+    for (const auto& [name, value] : counters) {
+        out << (first ? "\n" : ",\n") << "    \"" << name << "\": " << value;
+        first = false;
+    }
+    out << "\n  }\n}\n";
+}
+
+Profiler::Activation::Activation(Profiler& profiler)
+    : previous(current) {
+    current = &profiler;
+}
+
+Profiler::Activation::~Activation() {
+    current = previous;
+}
@@ -0,0 +1,66 @@
+#include "utils/StateRecordReader.hpp"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+template <typename T>
+void readColumn(std::FILE* in, std::vector<T>& column, std::size_t rows) {
+    column.resize(rows);
+    if (std::fread(column.data(), sizeof(T), rows, in) != rows) {
+        throw std::runtime_error("Truncated state recording");
+    }
+}
+
+} // namespace
+
+StateRecordReader::StateRecordReader(const std::string& filename)
+    : in(std::fopen(filename.c_str(), "rb")) {
+    if (!in) throw std::runtime_error("Cannot open state recording: " + filename);
+
+    staterec::FileHeader header{};
+    if (std::fread(&header, sizeof(header), 1, in) != 1
+        || std::memcmp(header.magic, staterec::kMagic, sizeof(header.magic)) != 0) {
+        std::fclose(in);
+        throw std::runtime_error("Not a state recording: " + filename);
+    }
+    if (header.version != staterec::kVersion || header.columnCount != staterec::kColumnCount) {
+        std::fclose(in);
+        throw std::runtime_error("Unsupported state recording version: " + filename);
+    }
+}
+
+StateRecordReader::~StateRecordReader() {
+    std::fclose(in);
+}
+
+bool StateRecordReader::next(staterec::Chunk& chunk) {
+    staterec::ChunkHeader header{};
+    if (std::fread(&header, sizeof(header), 1, in) != 1) return false;
+
+    std::size_t rows = header.rows;
+    readColumn(in, chunk.timestamp, rows);
+    readColumn(in, chunk.agentId, rows);
+    readColumn(in, chunk.cash, rows);
+    readColumn(in, chunk.inventory, rows);
+    readColumn(in, chunk.realized, rows);
+    readColumn(in, chunk.unrealized, rows);
+    return true;
+}
+
+void convertRecordingToCsv(const std::string& inputFile, const std::string& outputFile) {
+    StateRecordReader reader(inputFile);
+    std::ofstream out(outputFile);
+    if (!out) throw std::runtime_error("Cannot open CSV output: " + outputFile);
+
+    out << "timestamp,agent_id,cash,inventory,realized_pnl,unrealized_pnl,total_pnl\n";
+    staterec::Chunk chunk;
+    while (reader.next(chunk)) {
+        for (std::size_t i = 0; i < chunk.size(); ++i) {
+            double total = chunk.realized[i] + chunk.unrealized[i];
+            out << chunk.timestamp[i] << "," << chunk.agentId[i] << "," << chunk.cash[i] << "," << chunk.inventory[i]
+                << "," << chunk.realized[i] << "," << chunk.unrealized[i] << "," << total << "\n";
+        }
+    }
+}
@@ -0,0 +1,144 @@
+#include "utils/StateRecorder.hpp"
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace staterec {
+
+void Chunk::reserve(std::size_t rows) {
+    timestamp.reserve(rows);
+    agentId.reserve(rows);
+    cash.reserve(rows);
+    inventory.reserve(rows);
+    realized.reserve(rows);
+    unrealized.reserve(rows);
+}
+
+void Chunk::clear() {
+    timestamp.clear();
+    agentId.clear();
+    cash.clear();
+    inventory.clear();
+    realized.clear();
+    unrealized.clear();
+}
+
+} // namespace staterec
+
+namespace {
+
+template <typename T>
+bool writeColumn(std::FILE* out, const std::vector<T>& column) {
+    return std::fwrite(column.data(), sizeof(T), column.size(), out) == column.size();
+}
+
+bool writeChunk(std::FILE* out, const staterec::Chunk& chunk) {
+    staterec::ChunkHeader header{static_cast<std::uint32_t>(chunk.size()), 0};
+    return std::fwrite(&header, sizeof(header), 1, out) == 1
+           && writeColumn(out, chunk.timestamp)
+           && writeColumn(out, chunk.agentId)
+           && writeColumn(out, chunk.cash)
+           && writeColumn(out, chunk.inventory)
+           && writeColumn(out, chunk.realized)
+           && writeColumn(out, chunk.unrealized);
+}
+
+} // namespace
+
+StateRecorder::StateRecorder(const std::string& filename, std::size_t chunkRows)
+    : filename(filename),
+      out(nullptr),
+      failed(false),
+      chunkRows(chunkRows > 0 ? chunkRows : 1),
+      active(&buffers[0]),
+      pending(nullptr),
+      spare(&buffers[1]),
+      stopping(false) {
+    fs::path path(filename);
+    if (path.has_parent_path()) fs::create_directories(path.parent_path());
+
+    out = std::fopen(filename.c_str(), "wb");
+    if (!out) throw std::runtime_error("Cannot open state recording: " + filename);
+    // Whole chunks are written at once; stdio buffering would only add a copy
+    std::setvbuf(out, nullptr, _IONBF, 0);
+
+    staterec::FileHeader header{};
+    std::memcpy(header.magic, staterec::kMagic, sizeof(header.magic));
+    header.version = staterec::kVersion;
+    header.columnCount = staterec::kColumnCount;
+    if (std::fwrite(&header, sizeof(header), 1, out) != 1) {
+        std::fclose(out);
+        throw std::runtime_error("Cannot write state recording: " + filename);
+    }
+
+    for (auto& buffer : buffers) buffer.reserve(this->chunkRows);
+    writer = std::thread(&StateRecorder::writerLoop, this);
+}
+
+StateRecorder::~StateRecorder() {
+    finish();
+}
+
+void StateRecorder::log(int timestamp, const std::vector<std::shared_ptr<Agent>>& agents, double marketPrice) {
+    for (const auto& agent : agents) {
+        active->timestamp.push_back(timestamp);
+        active->agentId.push_back(agent->getId());
+        active->cash.push_back(agent->getCash());
+        active->inventory.push_back(agent->getInventory());
+        active->realized.push_back(agent->getRealizedPnL());
+        active->unrealized.push_back(agent->getUnrealizedPnL(marketPrice));
+        if (active->size() == chunkRows) submit();
+    }
+}
+
+void StateRecorder::submit() {
+    std::unique_lock lock(mutex);
+    // Wait for the writer to hand back the other buffer
+    cv.wait(lock, [this] { return spare != nullptr; });
+    pending = active;
+    active = spare;
+    spare = nullptr;
+    cv.notify_all();
+}
+
+void StateRecorder::writerLoop() {
+    std::unique_lock lock(mutex);
+    while (true) {
+        cv.wait(lock, [this] { return pending != nullptr || stopping; });
+        if (!pending) break;
+
+        staterec::Chunk* chunk = pending;
+        pending = nullptr;
+        lock.unlock();
+
+        // After a failed write the rest is dropped; close() reports it
+        if (!failed && !writeChunk(out, *chunk)) failed = true;
+        chunk->clear();
+
+        lock.lock();
+        spare = chunk;
+        cv.notify_all();
+    }
+}
+
+void StateRecorder::close() {
+    if (!finish()) throw std::runtime_error("Cannot write state recording: " + filename);
+}
+
+bool StateRecorder::finish() {
+    if (!out) return !failed;
+
+    if (active->size() > 0) submit();
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    writer.join();
+
+    if (std::fclose(out) != 0) failed = true;
+    out = nullptr;
+    return !failed;
+}
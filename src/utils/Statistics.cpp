@@ -0,0 +1,73 @@
+#include "utils/Statistics.hpp"
+#include <algorithm>
+#include <cmath>
+
+void RunningStats::add(double value) {
+    if (n == 0) {
+        minValue = maxValue = value;
+    } else {
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+    ++n;
+    double delta = value - meanValue;
+    meanValue += delta / static_cast<double>(n);
+    m2 += delta * (value - meanValue);
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.n == 0) return;
+    if (n == 0) {
+        *this = other;
+        return;
+    }
+    // Chan et al. parallel combination
+    std::uint64_t combined = n + other.n;
+    double delta = other.meanValue - meanValue;
+    meanValue += delta * static_cast<double>(other.n) / static_cast<double>(combined);
+    m2 += other.m2 + delta * delta * static_cast<double>(n) * static_cast<double>(other.n)
+                     / static_cast<double>(combined);
+    n = combined;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+}
+
+double RunningStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+Histogram::Histogram(double low, double high, std::size_t bins)
+    : low(low),
+      high(high > low ? high : low + 1.0),
+      counts(std::max<std::size_t>(bins, 1), 0) {}
+
+void Histogram::add(double value) {
+    double position = (value - low) / (high - low) * static_cast<double>(counts.size());
+    auto bin = static_cast<std::ptrdiff_t>(std::floor(position));
+    bin = std::clamp<std::ptrdiff_t>(bin, 0, static_cast<std::ptrdiff_t>(counts.size()) - 1);
+    ++counts[static_cast<std::size_t>(bin)];
+    ++total;
+}
+
+void Histogram::merge(const Histogram& other) {
+    if (other.counts.size() != counts.size()) return;
+    for (std::size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+    total += other.total;
+}
+
+double Histogram::quantile(double q) const {
+    if (total == 0) return 0.0;
+    double target = std::clamp(q, 0.0, 1.0) * static_cast<double>(total);
+    double width = (high - low) / static_cast<double>(counts.size());
+
+    double seen = 0.0;
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        double next = seen + static_cast<double>(counts[i]);
+        if (next >= target && counts[i] > 0) {
+            double fraction = (target - seen) / static_cast<double>(counts[i]);
+            return low + (static_cast<double>(i) + fraction) * width;
+        }
+        seen = next;
+    }
+    return high;
+}
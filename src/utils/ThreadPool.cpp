@@ -0,0 +1,77 @@
+#include "utils/ThreadPool.hpp"
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    if (threads == 0) threads = 1;
+    workers.reserve(threads - 1);
+    for (std::size_t chunk = 1; chunk < threads; ++chunk) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, chunk);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    startCv.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void ThreadPool::runChunk(std::size_t chunk) {
+    std::size_t chunks = size();
+    std::size_t begin = jobCount * chunk / chunks;
+    std::size_t end = jobCount * (chunk + 1) / chunks;
+    if (begin == end) return;
+
+    try {
+        (*job)(begin, end, chunk);
+    } catch (...) {
+        std::lock_guard lock(mutex);
+        if (!error) error = std::current_exception();
+    }
+}
+
+void ThreadPool::workerLoop(std::size_t chunk) {
+    std::size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            startCv.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        runChunk(chunk);
+
+        std::lock_guard lock(mutex);
+        if (--remaining == 0) doneCv.notify_one();
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t count, const ChunkFn& fn) {
+    if (workers.empty()) {
+        if (count > 0) fn(0, count, 0);
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        job = &fn;
+        jobCount = count;
+        remaining = workers.size();
+        error = nullptr;
+        ++generation;
+    }
+    startCv.notify_all();
+
+    runChunk(0);
+
+    std::exception_ptr failure;
+    {
+        std::unique_lock lock(mutex);
+        doneCv.wait(lock, [this] { return remaining == 0; });
+        job = nullptr;
+        failure = error;
+    }
+    if (failure) std::rethrow_exception(failure);
+}
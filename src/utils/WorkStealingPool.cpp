@@ -0,0 +1,95 @@
+#include "utils/WorkStealingPool.hpp"
+
+WorkStealingPool::WorkStealingPool(std::size_t threads) {
+    if (threads == 0) threads = 1;
+    for (std::size_t i = 0; i < threads; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    workCv.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void WorkStealingPool::submit(Task task) {
+    std::size_t target = nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(mutex);
+        ++queued;
+        ++pending;
+    }
+    workCv.notify_one();
+}
+
+bool WorkStealingPool::tryPop(std::size_t self, Task& task) {
+    Queue& queue = *queues[self];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::trySteal(std::size_t self, Task& task) {
+    for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+        Queue& victim = *queues[(self + offset) % queues.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(std::size_t self) {
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            workCv.wait(lock, [this] { return stopping || queued > 0; });
+            if (queued == 0) return;  // stopping with nothing left
+            --queued;
+        }
+
+        // A task is reserved for us; find it locally or steal it
+        Task task;
+        while (!tryPop(self, task) && !trySteal(self, task)) {
+            std::this_thread::yield();
+        }
+
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard lock(mutex);
+            if (!error) error = std::current_exception();
+        }
+
+        std::lock_guard lock(mutex);
+        if (--pending == 0) doneCv.notify_all();
+    }
+}
+
+void WorkStealingPool::wait() {
+    std::exception_ptr failure;
+    {
+        std::unique_lock lock(mutex);
+        doneCv.wait(lock, [this] { return pending == 0; });
+        failure = error;
+        error = nullptr;
+    }
+    if (failure) std::rethrow_exception(failure);
+}
@@ -0,0 +1,62 @@
+// Philox4x32-10 against the Random123 known answers, and the batch
+// generators against the sequential CounterRng.
+// Exits non-zero on the first failed check.
+#include "utils/CounterRng.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#define CHECK(cond)                                                               \
+    do {                                                                          \
+        if (!(cond)) {                                                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #cond "\n"; \
+            std::exit(1);                                                         \
+        }                                                                         \
+    } while (0)
+
+namespace {
+
+// From Random123's kat_vectors
+void knownAnswers() {
+    CHECK((philox::philox4x32({0, 0, 0, 0}, {0, 0})
+           == philox::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    CHECK((philox::philox4x32({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff})
+           == philox::Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    CHECK((philox::philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0})
+           == philox::Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+// Sizes around the lane count, so partial groups are covered
+void batchesMatchSequential() {
+    const std::uint64_t step = 0x1'0000'0003ULL;
+    const std::size_t sizes[] = {1, 7, philox::kLanes, 2 * philox::kLanes + 3, 100};
+    for (std::size_t n : sizes) {
+        std::vector<philox::Key> keys;
+        for (std::size_t i = 0; i < n; ++i) keys.push_back(philox::deriveKey(42, i));
+        std::vector<philox::Block> blocks(n);
+        philox::generateBlocks(keys, step, 2, 5, blocks);
+        for (std::size_t i = 0; i < n; ++i) {
+            CHECK((blocks[i] == philox::philox4x32({5, static_cast<std::uint32_t>(step), 1, 2}, keys[i])));
+        }
+
+        const philox::Key key = keys.back();
+        std::vector<double> doubles(n);
+        philox::uniformBatch(key, step, 2, doubles);
+        CounterRng doubleRng(key, step, 2);
+        for (double value : doubles) CHECK(value == doubleRng.uniform());
+
+        std::vector<int> ints(n);
+        philox::uniformIntBatch(key, step, 2, -3, 9, ints);
+        CounterRng intRng(key, step, 2);
+        for (int value : ints) CHECK(value == intRng.uniformInt(-3, 9));
+    }
+}
+
+} // namespace
+
+int main() {
+    knownAnswers();
+    batchesMatchSequential();
+    std::cout << "CounterRngTest passed\n";
+    return 0;
+}
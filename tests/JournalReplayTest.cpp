@@ -0,0 +1,70 @@
+// Journal replay of executions that set off parked stops.
+// Exits non-zero on the first failed check.
+#include "core/OrderBook.hpp"
+#include "core/OrderJournal.hpp"
+#include "utils/MappedFile.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+
+#define CHECK(cond)                                                               \
+    do {                                                                          \
+        if (!(cond)) {                                                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #cond "\n"; \
+            std::exit(1);                                                         \
+        }                                                                         \
+    } while (0)
+
+namespace {
+
+Order order(int agentId, OrderSide side, OrderType type, Tick price, int quantity, long timestamp) {
+    return Order{.id = 0, .agentId = agentId, .price = price, .quantity = quantity,
+                 .side = side, .type = type, .timestamp = timestamp};
+}
+
+void executeTriggersStop() {
+    auto path = std::filesystem::temp_directory_path() / "abms_journal_replay_test.bin";
+    std::uint64_t recordedFills = 0;
+    {
+        OrderJournal journal(path.string());
+        OrderBook book;
+        book.setJournal(&journal);
+
+        // Historical resting ask, then two agents' asks behind it
+        OrderHandle loaded = book.submitOrder(order(-1, OrderSide::SELL, OrderType::Limit, 10'100, 10, 1));
+        book.submitOrder(order(1, OrderSide::SELL, OrderType::Limit, 10'100, 10, 2));
+        book.submitOrder(order(2, OrderSide::SELL, OrderType::Limit, 10'101, 10, 3));
+        // Buy stops at the ask: a market and a limit one
+        book.submitOrder(order(3, OrderSide::BUY, OrderType::Stop, 0, 15, 4), OrderParams{.stopPrice = 10'100});
+        book.submitOrder(order(4, OrderSide::BUY, OrderType::StopLimit, 10'101, 12, 5),
+                         OrderParams{.stopPrice = 10'100});
+        book.clearFills();
+
+        // A historical execution trades at the stop price and releases both
+        CHECK(book.executeOrder(loaded, 4, 6));
+        for (const Fill& fill : book.getRecentFills()) recordedFills += !fill.isAggressor;
+        CHECK(recordedFills > 1);
+        book.clearFills();
+
+        // Later flow against what the stops left
+        book.submitOrder(order(5, OrderSide::SELL, OrderType::Limit, 10'101, 3, 7));
+        for (const Fill& fill : book.getRecentFills()) recordedFills += !fill.isAggressor;
+        book.setJournal(nullptr);
+        journal.close();
+    }
+
+    MappedFile file(path.string());
+    OrderBook replayed;
+    ReplayResult result = replayJournal(file.bytes(), replayed, true);
+    CHECK(result.mismatches == 0);
+    CHECK(result.trades == recordedFills);
+    std::filesystem::remove(path);
+}
+
+} // namespace
+
+int main() {
+    executeTriggersStop();
+    std::cout << "JournalReplayTest passed\n";
+    return 0;
+}
@@ -0,0 +1,214 @@
+// Self-trade policies and the IOC, FOK, stop, stop-limit and iceberg order types.
+// Exits non-zero on the first failed check.
+#include "core/OrderBook.hpp"
+#include <cstdlib>
+#include <iostream>
+
+#define CHECK(cond)                                                               \
+    do {                                                                          \
+        if (!(cond)) {                                                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #cond "\n"; \
+            std::exit(1);                                                         \
+        }                                                                         \
+    } while (0)
+
+namespace {
+
+// The book's initial last trade is at 10,000 ticks, below every price here,
+// so buy stops only fire once something trades
+constexpr Tick kAsk = 10'100;
+
+Order order(int agentId, OrderSide side, OrderType type, Tick price, int quantity) {
+    return Order{.id = 0, .agentId = agentId, .price = price, .quantity = quantity,
+                 .side = side, .type = type, .timestamp = 0};
+}
+
+Order sell(int agentId, Tick price, int quantity) {
+    return order(agentId, OrderSide::SELL, OrderType::Limit, price, quantity);
+}
+
+Order marketBuy(int agentId, int quantity) {
+    return order(agentId, OrderSide::BUY, OrderType::Market, 0, quantity);
+}
+
+std::int64_t askDepth(const OrderBook& book, Tick price) {
+    std::int64_t total = 0;
+    auto asks = book.getAsks();
+    auto level = asks.find(OrderBook::toPrice(price));
+    if (level == asks.end()) return 0;
+    for (const Order& resting : level->second) total += resting.quantity;
+    return total;
+}
+
+// Whether every fill since the last clearFills() is a trade between
+// `passive` and `aggressor`, for `quantity` in total
+bool tradedOnly(const OrderBook& book, int passive, int aggressor, int quantity) {
+    int bought = 0;
+    for (const Fill& fill : book.getRecentFills()) {
+        if (fill.agentId != (fill.isAggressor ? aggressor : passive)) return false;
+        if (fill.isAggressor) bought += fill.quantity;
+    }
+    return bought == quantity;
+}
+
+// Agent 1's own ask at the front, agent 2's behind it
+OrderBook ownOrderFirst(SelfTradePolicy policy) {
+    OrderBook book;
+    book.setSelfTradePolicy(policy);
+    book.addLimitOrder(sell(1, kAsk, 3));
+    book.addLimitOrder(sell(2, kAsk, 5));
+    return book;
+}
+
+void skip() {
+    OrderBook book = ownOrderFirst(SelfTradePolicy::Skip);
+    CHECK(book.matchMarketOrder(marketBuy(1, 5), FillSink()) == 5);
+    CHECK(tradedOnly(book, 2, 1, 5));
+    CHECK(askDepth(book, kAsk) == 3);
+}
+
+void cancelResting() {
+    OrderBook book = ownOrderFirst(SelfTradePolicy::CancelResting);
+    CHECK(book.matchMarketOrder(marketBuy(1, 5), FillSink()) == 5);
+    CHECK(tradedOnly(book, 2, 1, 5));
+    CHECK(!book.bestAsk());
+}
+
+void cancelAggressor() {
+    OrderBook book = ownOrderFirst(SelfTradePolicy::CancelAggressor);
+    CHECK(book.matchMarketOrder(marketBuy(1, 5), FillSink()) == 0);
+    CHECK(book.getRecentFills().empty());
+    CHECK(askDepth(book, kAsk) == 8);
+}
+
+void decrementBoth() {
+    OrderBook book = ownOrderFirst(SelfTradePolicy::DecrementBoth);
+    // 3 cancelled against the own ask, 2 traded with agent 2
+    CHECK(book.matchMarketOrder(marketBuy(1, 5), FillSink()) == 2);
+    CHECK(tradedOnly(book, 2, 1, 2));
+    CHECK(askDepth(book, kAsk) == 3);
+}
+
+// The aggressor's own iceberg last in the queue: each refilled slice comes
+// round again and is decremented, never traded, and the aggressor stays at
+// the level until it is used up
+void decrementBothIceberg() {
+    OrderBook book;
+    book.setSelfTradePolicy(SelfTradePolicy::DecrementBoth);
+    book.addLimitOrder(sell(2, kAsk, 2));
+    OrderHandle iceberg = book.submitOrder(order(1, OrderSide::SELL, OrderType::Iceberg, kAsk, 30),
+                                           OrderParams{.displayQuantity = 10});
+    book.addLimitOrder(sell(3, kAsk + 1, 10));
+
+    CHECK(book.matchMarketOrder(marketBuy(1, 25), FillSink()) == 2);
+    CHECK(tradedOnly(book, 2, 1, 2));
+    CHECK(askDepth(book, kAsk + 1) == 10);
+    // 23 taken off the iceberg: 7 left, all of it on display
+    CHECK(book.findOrder(iceberg) && book.findOrder(iceberg)->quantity == 7);
+    CHECK(askDepth(book, kAsk) == 7);
+}
+
+void immediateOrCancel() {
+    OrderBook book;
+    book.addLimitOrder(sell(2, kAsk, 5));
+    OrderHandle left = book.submitOrder(order(1, OrderSide::BUY, OrderType::IOC, kAsk, 8));
+    CHECK(!left);
+    CHECK(tradedOnly(book, 2, 1, 5));
+    CHECK(!book.bestBid());
+    CHECK(!book.bestAsk());
+}
+
+void fillOrKill() {
+    OrderBook book;
+    book.addLimitOrder(sell(2, kAsk, 5));
+    book.submitOrder(order(1, OrderSide::BUY, OrderType::FOK, kAsk, 8));
+    CHECK(book.getRecentFills().empty());
+    CHECK(askDepth(book, kAsk) == 5);
+
+    book.submitOrder(order(1, OrderSide::BUY, OrderType::FOK, kAsk, 5));
+    CHECK(tradedOnly(book, 2, 1, 5));
+    CHECK(!book.bestAsk());
+    CHECK(!book.bestBid());
+}
+
+void stop() {
+    OrderBook book;
+    book.addLimitOrder(sell(2, kAsk, 5));
+    book.addLimitOrder(sell(2, kAsk + 2, 5));
+    OrderHandle parked = book.submitOrder(order(3, OrderSide::BUY, OrderType::Stop, 0, 4),
+                                          OrderParams{.stopPrice = kAsk});
+    CHECK(book.findOrder(parked));
+    CHECK(book.getRecentFills().empty());
+
+    // A trade at the stop price releases it as a market order
+    book.matchMarketOrder(marketBuy(1, 2), FillSink());
+    CHECK(!book.findOrder(parked));
+    int stopBought = 0;
+    for (const Fill& fill : book.getRecentFills()) {
+        if (fill.agentId == 3) stopBought += fill.quantity;
+    }
+    CHECK(stopBought == 4);
+    CHECK(askDepth(book, kAsk) == 0);
+    CHECK(askDepth(book, kAsk + 2) == 4);
+}
+
+void stopLimit() {
+    OrderBook book;
+    book.addLimitOrder(sell(2, kAsk, 5));
+    book.addLimitOrder(sell(2, kAsk + 2, 5));
+    OrderHandle parked = book.submitOrder(order(3, OrderSide::BUY, OrderType::StopLimit, kAsk, 8),
+                                          OrderParams{.stopPrice = kAsk});
+
+    // Released as a limit at kAsk: takes what is left there and rests the
+    // rest under the same handle
+    book.matchMarketOrder(marketBuy(1, 1), FillSink());
+    const Order* rested = book.findOrder(parked);
+    CHECK(rested && rested->type == OrderType::Limit && rested->quantity == 4);
+    CHECK(book.bestBid() == OrderBook::toPrice(kAsk));
+    CHECK(askDepth(book, kAsk + 2) == 5);
+}
+
+void icebergRefill() {
+    OrderBook book;
+    OrderHandle iceberg = book.submitOrder(order(2, OrderSide::SELL, OrderType::Iceberg, kAsk, 25),
+                                           OrderParams{.displayQuantity = 10});
+    book.addLimitOrder(sell(4, kAsk, 5));
+    CHECK(askDepth(book, kAsk) == 15);
+
+    // The first slice fills; the next one goes behind agent 4
+    book.matchMarketOrder(marketBuy(1, 10), FillSink());
+    CHECK(tradedOnly(book, 2, 1, 10));
+    CHECK(book.findOrder(iceberg)->quantity == 10);
+    book.clearFills();
+
+    book.matchMarketOrder(marketBuy(1, 7), FillSink());
+    const auto& fills = book.getRecentFills();
+    CHECK(fills.size() == 4);
+    CHECK(fills[0].agentId == 4 && fills[0].quantity == 5);
+    CHECK(fills[2].agentId == 2 && fills[2].quantity == 2);
+    book.clearFills();
+
+    // 8 displayed and 5 in reserve: reducing takes the reserve first
+    CHECK(book.reduceOrder(iceberg, 6));
+    CHECK(book.findOrder(iceberg)->quantity == 7);
+    book.matchMarketOrder(marketBuy(1, 7), FillSink());
+    CHECK(!book.findOrder(iceberg));
+    CHECK(!book.bestAsk());
+}
+
+} // namespace
+
+int main() {
+    skip();
+    cancelResting();
+    cancelAggressor();
+    decrementBoth();
+    decrementBothIceberg();
+    immediateOrCancel();
+    fillOrKill();
+    stop();
+    stopLimit();
+    icebergRefill();
+    std::cout << "OrderTypesTest passed\n";
+    return 0;
+}
@@ -0,0 +1,107 @@
+// Price ladder and order book with levels far outside the dense window.
+// Exits non-zero on the first failed check.
+#include "core/OrderBook.hpp"
+#include "core/PriceLadder.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+
+#define CHECK(cond)                                                               \
+    do {                                                                          \
+        if (!(cond)) {                                                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #cond "\n"; \
+            std::exit(1);                                                         \
+        }                                                                         \
+    } while (0)
+
+namespace {
+
+Order limit(int agentId, OrderSide side, Tick price, int quantity) {
+    return Order{.id = 0, .agentId = agentId, .price = price, .quantity = quantity,
+                 .side = side, .type = OrderType::Limit, .timestamp = 0};
+}
+
+// Stub quotes at both ends of the band next to a normal market
+void farOutliers() {
+    OrderBook book;
+    constexpr Tick maxTick = DefaultBookConfig::maxTick;
+    book.addLimitOrder(limit(1, OrderSide::SELL, 10'000, 10));
+    book.addLimitOrder(limit(2, OrderSide::BUY, 1, 10));
+    book.addLimitOrder(limit(3, OrderSide::SELL, maxTick, 10));
+    book.addLimitOrder(limit(4, OrderSide::BUY, 9'990, 5));
+
+    CHECK(book.bestAsk() == OrderBook::toPrice(10'000));
+    CHECK(book.bestBid() == OrderBook::toPrice(9'990));
+    auto asks = book.getAsks();
+    CHECK(asks.size() == 2);
+    CHECK(asks.rbegin()->first == OrderBook::toPrice(maxTick));
+
+    // Sweeping the asks walks from the window into the far level
+    std::vector<Fill> fills;
+    book.addLimitOrder(limit(5, OrderSide::BUY, maxTick, 20), &fills);
+    CHECK(fills.size() == 2);
+    CHECK(fills[1].price == maxTick);
+    CHECK(!book.bestAsk());
+
+    // With the near bid gone the stub bid at one tick is the touch
+    book.addLimitOrder(limit(6, OrderSide::SELL, 1, 5));
+    CHECK(book.bestBid() == OrderBook::toPrice(1));
+    fills.clear();
+    book.addLimitOrder(limit(7, OrderSide::SELL, 1, 15), &fills);
+    CHECK(fills.size() == 1);
+    CHECK(fills[0].price == 1);
+    CHECK(book.bestAsk() == OrderBook::toPrice(1));
+    CHECK(!book.bestBid());
+}
+
+// Random adds and releases over a wide range against a std::set
+void matchesReference() {
+    for (auto touch : {PriceLadder::Touch::Lowest, PriceLadder::Touch::Highest}) {
+        PriceLadder ladder(touch, 10'000, 256);
+        std::set<Tick> reference;
+        std::mt19937_64 rng(42);
+        std::uniform_int_distribution<Tick> near(9'000, 11'000);
+        std::uniform_int_distribution<Tick> far(1, DefaultBookConfig::maxTick);
+
+        for (int i = 0; i < 20'000; ++i) {
+            Tick tick = (rng() % 10 == 0) ? far(rng) : near(rng);
+            if (rng() % 3 == 0 && !reference.empty()) {
+                auto it = reference.lower_bound(tick);
+                Tick victim = (it == reference.end()) ? *reference.begin() : *it;
+                ladder.release(victim);
+                reference.erase(victim);
+            } else {
+                ladder.acquire(tick).orderCount = static_cast<std::uint32_t>(tick % 1000);
+                reference.insert(tick);
+            }
+
+            CHECK(ladder.levelCount() == reference.size());
+            if (reference.empty()) {
+                CHECK(!ladder.lowest() && !ladder.highest());
+                continue;
+            }
+            CHECK(ladder.lowest() == *reference.begin());
+            CHECK(ladder.highest() == *reference.rbegin());
+            auto above = reference.upper_bound(tick);
+            CHECK(ladder.nextHigher(tick) == (above == reference.end() ? std::optional<Tick>() : *above));
+            auto below = reference.lower_bound(tick);
+            CHECK(ladder.nextLower(tick) == (below == reference.begin() ? std::optional<Tick>() : *std::prev(below)));
+        }
+
+        // Every level kept its contents through the moves
+        for (Tick tick : reference) {
+            const auto* level = ladder.find(tick);
+            CHECK(level && level->orderCount == static_cast<std::uint32_t>(tick % 1000));
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    farOutliers();
+    matchesReference();
+    std::cout << "PriceLadderTest passed\n";
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "core/OrderBook.hpp"
+#include "core/OrderJournal.hpp"
+#include "utils/MappedFile.hpp"
+
+// Replays an order-flow journal into a fresh OrderBook with no agents, as a
+// matching-engine throughput benchmark and a check that today's book still
+// produces the recorded fills.
+int main(int argc, char** argv) {
+    std::string path;
+    bool verify = true;
+    int repeat = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--no-verify") {
+            verify = false;
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max(1, std::stoi(argv[++i]));
+        } else if (path.empty() && !arg.starts_with("--")) {
+            path = arg;
+        } else {
+            path.clear();
+            break;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <journal.bin> [--no-verify] [--repeat N]\n";
+        return 1;
+    }
+
+    try {
+        MappedFile file(path);
+        ReplayResult result;
+        double best = 0.0;
+        for (int run = 0; run < repeat; ++run) {
+            OrderBook book;
+            auto start = std::chrono::steady_clock::now();
+            result = replayJournal(file.bytes(), book, verify);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (run == 0 || seconds < best) best = seconds;
+        }
+
+        std::uint64_t calls = result.orders + result.cancels;
+        std::cout << "Records: " << result.records << " | Orders: " << result.orders
+                  << " | Cancels: " << result.cancels << " | Fills: " << result.trades << "\n";
+        std::cout << std::fixed << std::setprecision(3) << "Replay: " << best * 1e3 << " ms"
+                  << (repeat > 1 ? " (best of " + std::to_string(repeat) + ")" : "")
+                  << " | " << std::setprecision(2) << (best > 0 ? calls / best / 1e6 : 0.0)
+                  << " M calls/s\n";
+
+        if (!verify) return 0;
+        if (result.mismatches == 0) {
+            std::cout << "Fills match the recording\n";
+            return 0;
+        }
+        std::cout << "MISMATCH: " << result.mismatches << " record(s) differ, first at record "
+                  << result.firstMismatch << "\n";
+        return 2;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,20 @@
+#include <exception>
+#include <iostream>
+#include "utils/StateRecordReader.hpp"
+
+// Converts a binary state recording (logs/simulation.bin) to the CSV layout
+// the simulator used to write directly.
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <recording.bin> <output.csv>\n";
+        return 1;
+    }
+
+    try {
+        convertRecordingToCsv(argv[1], argv[2]);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}